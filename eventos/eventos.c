@@ -80,6 +80,59 @@ enum {
 
 #define EOS_MAGIC_NUMBER                    0xDEADBEEF
 
+#define EOS_SUB_BIT(priority_)              ((eos_sub_t)1 << (priority_))
+#define EOS_SUB_ALL                         ((eos_sub_t)(~(eos_sub_t)0))
+
+// 主题的订阅者，由编译期的订阅表与运行时的订阅表叠加而成
+#if (EOS_USE_PUB_SUB != 0 && EOS_USE_SUB_CONST != 0)
+#define EOS_SUB_NONE()                      (eos.sub_table == EOS_NULL && eos.sub_const == EOS_NULL)
+#define EOS_SUB_READ(topic_)                (eos_sub_read(topic_))
+#elif (EOS_USE_PUB_SUB != 0)
+#define EOS_SUB_NONE()                      (eos.sub_table == EOS_NULL)
+#define EOS_SUB_READ(topic_)                (eos.sub_table[topic_])
+#endif
+
+// 最高优先级的就绪Actor，在32位MCU且使用GCC/Clang时由CLZ指令得到，否则查4位的表。没有
+// CLZ且Actor多于8个时，就绪位图增加一级，每8个Actor对应一位。
+#if (EOS_MCU_TYPE == 32 && defined(__GNUC__))
+#define EOS_USE_CLZ                         1
+#else
+#define EOS_USE_CLZ                         0
+#endif
+#if (EOS_USE_CLZ == 0 && EOS_MAX_ACTORS > 8)
+#define EOS_USE_SUB_GROUP                   1
+#else
+#define EOS_USE_SUB_GROUP                   0
+#endif
+
+// GCC/Clang的16位原子操作无锁时，入口环以CAS占用槽位，层次状态的缓存以原子读写发布，
+// 在Cortex-M3及以上编译为LDREX/STREX。Cortex-M0等ARMv6-M没有LDREX/STREX，原子操作会编
+// 译为需要libatomic的库函数，此时占用槽位在临界区中进行。
+#if (EOS_MCU_TYPE == 32 && defined(__GNUC__) && defined(__GCC_ATOMIC_SHORT_LOCK_FREE) && \
+     (__GCC_ATOMIC_SHORT_LOCK_FREE == 2) && (!defined(__arm__) || __ARM_ARCH >= 7))
+#define EOS_USE_ATOMIC                      1
+#else
+#define EOS_USE_ATOMIC                      0
+#endif
+
+// 多个worker时，定时事件与入口环的取出由各线程共用，由临界区保护，此时临界区必须可重入。
+#if (EOS_USE_MULTI_WORKER != 0)
+#define EOS_WORKER_LOCK()                   eos_port_critical_enter()
+#define EOS_WORKER_UNLOCK()                 eos_port_critical_exit()
+#else
+#define EOS_WORKER_LOCK()                   ((void)0)
+#define EOS_WORKER_UNLOCK()                 ((void)0)
+#endif
+
+// 只有一个worker运行全部Actor时，Actor之间才会抢占。
+#if (EOS_USE_PREEMPT != 0)
+#if (EOS_USE_MULTI_WORKER != 0)
+#define EOS_PREEMPT_ENABLED()               (eos.worker_num == 1)
+#else
+#define EOS_PREEMPT_ENABLED()               (1)
+#endif
+#endif
+
 #if (EOS_USE_TIME_EVENT != 0)
 #define EOS_MS_NUM_30DAY                    (2592000000)
 
@@ -110,6 +163,21 @@ typedef struct eos_event_timer {
     eos_u32_t period                        : 16;
     eos_u32_t timeout_ms;
 } eos_event_timer_t;
+
+#if (EOS_USE_TIMER_MIN_HEAP != 0)
+#define EOS_TIMER_NULL                      0xffff
+#if (EOS_MAX_TIME_EVENT <= 16)
+#define EOS_TIMER_HASH_SIZE                 16
+#elif (EOS_MAX_TIME_EVENT <= 64)
+#define EOS_TIMER_HASH_SIZE                 64
+#elif (EOS_MAX_TIME_EVENT <= 256)
+#define EOS_TIMER_HASH_SIZE                 256
+#elif (EOS_MAX_TIME_EVENT <= 1024)
+#define EOS_TIMER_HASH_SIZE                 1024
+#else
+#define EOS_TIMER_HASH_SIZE                 4096
+#endif
+#endif
 #endif
 
 typedef struct eos_block {
@@ -126,10 +194,74 @@ typedef struct eos_block {
 } eos_block_t;
 
 typedef struct eos_event_inner {
+    eos_u32_t seq;                                      // publish order
     eos_sub_t sub;
     eos_topic_t topic;
+#if (EOS_USE_EVENT_REF != 0)
+    eos_u8_t ref;                                       // holders of the data
+#endif
 } eos_event_inner_t;
 
+// 不携带数据的事件的记录，存放在环中而不是堆中
+typedef struct eos_event_record {
+    eos_u32_t seq;
+    eos_sub_t sub;
+    eos_topic_t topic;
+} eos_event_record_t;
+
+typedef struct eos_ring {
+    eos_event_record_t record[EOS_SIZE_TOPIC_QUEUE];
+    eos_u16_t head;                                     // serial of the oldest record
+    eos_u16_t count;
+    // per-actor serial of the next record to check
+    eos_u16_t cursor[EOS_MAX_ACTORS];
+} eos_ring_t;
+
+#if (EOS_USE_PUB_INGRESS != 0)
+// 无锁的多生产者单消费者主题环，发布者写入，由eos_once取出
+typedef struct eos_ingress {
+    // slot state: serial while free, serial + 1 while filled
+    eos_u16_t state[EOS_SIZE_PUB_INGRESS];
+    eos_topic_t topic[EOS_SIZE_PUB_INGRESS];
+    eos_u16_t tail;                                     // next serial to claim
+    eos_u16_t head;                                     // next serial to drain
+} eos_ingress_t;
+#endif
+
+#if (EOS_USE_EVENT_BRIDGE != 0)
+// 事件桥环中记录的头部，之后为数据，4字节对齐
+typedef struct eos_bridge_record {
+    eos_u16_t topic;
+    eos_u16_t size;
+} eos_bridge_record_t;
+
+#if (EOS_USE_BRIDGE_STREAM != 0)
+// 字节流传输，帧经COBS编码，以0x00结尾
+typedef struct eos_bridge_stream {
+    eos_u8_t tx[2][EOS_SIZE_BRIDGE_FRAME];                  // frame being filled and frame being sent
+    eos_u16_t tx_len;
+    eos_u16_t tx_code;                                      // index of the open COBS code byte
+    eos_u16_t tx_crc;
+    eos_u16_t tx_sealed;                                    // length of tx[1 - tx_index] to send, or 0
+    eos_u8_t tx_run;                                        // value of the open COBS code byte
+    eos_u8_t tx_index;                                      // tx[tx_index] is being filled
+    eos_u8_t tx_count;                                      // events in the frame being filled
+    eos_u8_t enabled;
+    eos_u8_t rx[EOS_SIZE_BRIDGE_FRAME];                     // decoded frame being received
+    eos_u16_t rx_len;
+    eos_u8_t rx_code;                                       // last COBS code byte
+    eos_u8_t rx_remain;                                     // data bytes left in the code block
+    eos_u8_t rx_overflow;
+    eos_u32_t lost;                                         // events dropped by both sides
+    eos_u32_t error;                                        // frames dropped by the receiver
+} eos_bridge_stream_t;
+#endif
+#endif
+
+#if (EOS_USE_HEAP_BIN != 0)
+#define EOS_HEAP_BIN_NUM                    6
+#endif
+
 typedef struct eos_heap {
 #if (EOS_USE_MAGIC != 0)
     eos_u32_t magic;
@@ -142,32 +274,106 @@ typedef struct eos_heap {
     // word[2]
     eos_u32_t current                       : 15;
     eos_u32_t empty                         : 1;
+    eos_u32_t tail                          : 15;       /* queue's last block */
     // word[2]
-    eos_sub_t sub_general;
-    eos_sub_t count;
+    eos_u16_t count;
+    // per-actor scan start in the queue, blocks before it hold no sub bit of the actor
+    eos_u16_t cursor[EOS_MAX_ACTORS];
+#if (EOS_USE_HEAP_BIN != 0)
+    // free lists of the size classes, linked by q_next
+    eos_u16_t bin[EOS_HEAP_BIN_NUM];
+    eos_u8_t bin_en;
+#endif
 } eos_heap_t;
 
+#if (EOS_USE_HSM_CACHE != 0)
+// 层次状态机拓扑中的一个状态，以其状态函数为键
+typedef struct eos_hsm_node {
+    eos_state_handler state;                                // EOS_NULL: empty slot
+    eos_state_handler parent;
+    struct eos_hsm_node *up;                                // node of parent, set on first use
+    eos_u8_t depth;                                         // eos_state_top is 0
+} eos_hsm_node_t;
+#endif
+
 typedef struct eos_tag {
 #if (EOS_USE_MAGIC != 0)
     eos_u32_t magic;
 #endif
 #if (EOS_USE_PUB_SUB != 0)
-    eos_mcu_t *sub_table;                                     // event sub table
+    eos_sub_t *sub_table;                                     // event sub table
+#if (EOS_USE_SUB_CONST != 0)
+    eos_sub_t const *sub_const;                             // sub table fixed at compile time
+#endif
+    eos_topic_t topic_max;
 #endif
 
-    eos_mcu_t actor_exist;
-    eos_mcu_t actor_enabled;
+    eos_sub_t actor_exist;
+    eos_sub_t actor_enabled;
     eos_actor_t * actor[EOS_MAX_ACTORS];
+#if (EOS_USE_HSM_CACHE != 0)
+    eos_hsm_node_t hsm_node[EOS_MAX_HSM_STATES];            // states hashed by handler
+    eos_u16_t hsm_count;
+#endif
 
 #if (EOS_USE_EVENT_DATA != 0)
     eos_heap_t heap;
 #endif
+    eos_ring_t ring;
+#if (EOS_USE_PUB_INGRESS != 0)
+    eos_ingress_t ingress;
+#endif
+#if (EOS_USE_EVENT_BRIDGE != 0)
+    eos_bridge_ring_t *bridge_tx;                           // shared rings of the attached bridge
+    eos_bridge_ring_t *bridge_rx;
+    eos_topic_t bridge_topic[EOS_MAX_BRIDGE_TOPIC];         // topics exported to the peer
+    eos_u8_t bridge_count;
+#if (EOS_USE_BRIDGE_STREAM != 0)
+    eos_bridge_stream_t stream;
+#endif
+#endif
+    eos_sub_t sub_general;                                  // actors with events
+#if (EOS_USE_SUB_GROUP != 0)
+    eos_u8_t sub_group;                                     // bit g: sub_general byte g != 0
+#endif
+    // per-actor pending event count, sub_general bit i is set while pending[i] != 0
+    eos_u16_t pending[EOS_MAX_ACTORS];
+    eos_u32_t seq;                                          // publish order, 32-bit to compare old events
+    eos_u8_t batch;                                         // max events per actor per pass
+#if (EOS_USE_MULTI_WORKER != 0)
+    eos_sub_t worker_mask[EOS_MAX_WORKERS];                 // actors bound to each worker
+    eos_sub_t sub_busy;                                     // actors being dispatched
+    eos_u8_t worker_num;
+    eos_u8_t steal;                                         // idle workers steal ready actors
+#endif
+#if (EOS_USE_PREEMPT != 0)
+    eos_u8_t prio_run;                                      // running priority + 1 or ceiling, 0: idle
+#endif
 
 #if (EOS_USE_TIME_EVENT != 0)
     eos_event_timer_t etimer[EOS_MAX_TIME_EVENT];
     eos_u32_t time;
     eos_u32_t timeout_min;
-    eos_u8_t timer_count;
+    eos_u16_t timer_count;
+#if (EOS_USE_TIMER_MIN_HEAP != 0)
+    // min-heap of etimer indexes ordered by timeout_ms, and each timer's place in it
+    eos_u16_t timer_heap[EOS_MAX_TIME_EVENT];
+    eos_u16_t timer_pos[EOS_MAX_TIME_EVENT];
+    eos_u16_t timer_heap_size;
+    // etimer indexes hashed by topic, chained by timer_next
+    eos_u16_t timer_hash[EOS_TIMER_HASH_SIZE];
+    eos_u16_t timer_next[EOS_MAX_TIME_EVENT];
+#endif
+    // actors parked by eos_delay(), and those of them dropping blocked events
+    eos_sub_t sub_delay;
+    eos_sub_t sub_block;
+    eos_u32_t delay_ms[EOS_MAX_ACTORS];                     // wake-up time of each actor
+    eos_u32_t delay_min;
+    eos_topic_t unblocked[EOS_MAX_UNBLOCKED_TOPIC];
+    eos_u8_t unblocked_count;
+#if (EOS_USE_MULTI_WORKER == 0)
+    eos_u8_t actor_run;                                     // running actor, EOS_MAX_ACTORS: none
+#endif
 #endif
 
     eos_u8_t enabled                        : 1;
@@ -177,14 +383,30 @@ typedef struct eos_tag {
 
 /* eventos API for test ----------------------------- */
 eos_s8_t eos_once(void);
+#if (EOS_USE_MULTI_WORKER != 0)
+eos_s8_t eos_worker_once(eos_u8_t worker);
+#endif
 eos_s8_t eos_event_pub_ret(eos_topic_t topic, void *data, eos_u32_t size);
 void * eos_get_framework(void);
 void eos_event_pub_time(eos_topic_t topic, eos_u32_t time_ms, eos_bool_t oneshoot);
 void eos_set_time(eos_u32_t time_ms);
+#if (EOS_USE_TIME_EVENT != 0)
+eos_u8_t eos_actor_current(void);
+#endif
 // **eos end** -----------------------------------------------------------------
 
 static eos_t eos;
 
+#if (EOS_USE_TIME_EVENT != 0)
+#if (EOS_USE_MULTI_WORKER != 0)
+// 多个worker并行分发，正在运行的Actor由各worker线程分别记录
+static __thread eos_u8_t eos_actor_run = EOS_MAX_ACTORS;
+#define EOS_ACTOR_RUN                       eos_actor_run
+#else
+#define EOS_ACTOR_RUN                       eos.actor_run
+#endif
+#endif
+
 // data ------------------------------------------------------------------------
 #if (EOS_USE_SM_MODE != 0)
 static const eos_event_t eos_event_table[Event_User] = {
@@ -206,24 +428,100 @@ static const eos_event_t eos_event_table[Event_User] = {
 // static function -------------------------------------------------------------
 #if (EOS_USE_SM_MODE != 0)
 static void eos_sm_dispath(eos_sm_t * const me, eos_event_t const * const e);
-#if (EOS_USE_HSM_MODE != 0)
-static eos_s32_t eos_sm_tran(eos_sm_t * const me, eos_state_handler path[EOS_MAX_HSM_NEST_DEPTH]);
+#if (EOS_USE_HSM_MODE != 0 && EOS_USE_HSM_CACHE == 0)
+static eos_s32_t eos_sm_tran(eos_sm_t * const me, eos_state_handler path[EOS_MAX_HSM_NEST_DEPTH + 1]);
+#endif
+#endif
+#if (EOS_USE_HSM_CACHE != 0)
+static void eos_hsm_cache_init(void);
+static eos_hsm_node_t *eos_hsm_node(eos_sm_t * const me, eos_state_handler state);
+static eos_hsm_node_t *eos_hsm_up(eos_sm_t * const me, eos_hsm_node_t *node);
+static eos_hsm_node_t *eos_hsm_lca(eos_sm_t * const me,
+                                   eos_hsm_node_t *source, eos_hsm_node_t *target);
+static void eos_hsm_exit(eos_sm_t * const me, eos_hsm_node_t *from, eos_state_handler to);
+static void eos_hsm_enter(eos_sm_t * const me, eos_hsm_node_t *from, eos_hsm_node_t *to);
+static void eos_hsm_drill(eos_sm_t * const me, eos_state_handler state);
+#if (EOS_USE_HSM_TRAN_CACHE != 0)
+static eos_sm_tran_t *eos_sm_tran_get(eos_sm_t * const me,
+                                      eos_state_handler source, eos_state_handler target);
 #endif
 #endif
 #if (EOS_USE_EVENT_DATA != 0)
 void eos_heap_init(eos_heap_t * const me);
 void * eos_heap_malloc(eos_heap_t * const me, eos_u32_t size);
+void * eos_heap_reserve(eos_heap_t * const me, eos_u32_t size);
+void eos_heap_commit(eos_heap_t * const me, void * data);
 void eos_heap_free(eos_heap_t * const me, void * data);
 void *eos_heap_get_block(eos_heap_t * const me, eos_u8_t priority);
 void eos_heap_gc(eos_heap_t * const me, void *data);
+static void eos_heap_release(eos_heap_t * const me, eos_block_t * block);
+static void *eos_heap_find(eos_heap_t * const me, eos_u8_t priority);
+#if (EOS_USE_HEAP_BIN != 0)
+void eos_heap_init_bin(eos_heap_t * const me);
+void eos_heap_bin_flush(eos_heap_t * const me);
+#endif
+#endif
+static eos_u8_t eos_sub_highest(eos_sub_t sub);
+#if (EOS_USE_MULTI_WORKER == 0)
+static eos_u8_t eos_ready_highest(void);
+#endif
+static eos_s8_t eos_schedule(eos_u8_t worker, eos_sub_t mask);
+static eos_s8_t eos_dispatch(eos_u8_t *priority_, eos_sub_t mask);
+#if (EOS_USE_PREEMPT != 0)
+static eos_sub_t eos_sub_above(eos_u8_t n);
+static void eos_preempt_check(eos_sub_t sub);
+#endif
+#if (EOS_USE_TIME_EVENT != 0)
+static void eos_delay_start(eos_u32_t time_ms, eos_bool_t block);
+static void eos_delay_check(void);
+static eos_bool_t eos_event_unblocked(eos_topic_t topic);
+#endif
+#if (EOS_USE_TIME_EVENT != 0 && EOS_USE_TIMER_MIN_HEAP != 0)
+static void eos_timer_init(void);
+static eos_u16_t eos_timer_find(eos_topic_t topic);
+static void eos_timer_add(void);
+static void eos_timer_remove(eos_u16_t index);
+static void eos_timer_sift_up(eos_u16_t pos);
+static void eos_timer_sift_down(eos_u16_t pos);
+#endif
+void eos_ring_init(eos_ring_t * const me);
+eos_event_record_t * eos_ring_push(eos_ring_t * const me);
+eos_event_record_t * eos_ring_find(eos_ring_t * const me, eos_u8_t priority);
+void eos_ring_take(eos_ring_t * const me, eos_event_record_t * record, eos_u8_t priority);
+#if (EOS_USE_PUB_INGRESS != 0)
+void eos_ingress_init(eos_ingress_t * const me);
+eos_bool_t eos_ingress_push(eos_ingress_t * const me, eos_topic_t topic);
+eos_bool_t eos_ingress_pop(eos_ingress_t * const me, eos_topic_t *topic);
+static void eos_ingress_drain(void);
+#endif
+#if (EOS_USE_EVENT_BRIDGE != 0)
+void eos_bridge_ring_init(eos_bridge_ring_t * const me);
+static eos_bool_t eos_bridge_write(eos_bridge_ring_t * const me,
+                                   eos_topic_t topic, void const *data, eos_u32_t size);
+eos_bridge_record_t * eos_bridge_peek(eos_bridge_ring_t * const me);
+void eos_bridge_take(eos_bridge_ring_t * const me, eos_bridge_record_t * const record);
+static eos_bool_t eos_bridge_forward(eos_topic_t topic, void const *data, eos_u32_t size);
+static void eos_bridge_poll(void);
+#if (EOS_USE_BRIDGE_STREAM != 0)
+static void eos_stream_append(eos_topic_t topic, void const *data, eos_u32_t size);
+#endif
+#endif
+static eos_s8_t eos_event_pub_local(eos_topic_t topic, void *data, eos_u32_t size);
+#if (EOS_USE_EVENT_DATA != 0)
+static void eos_event_enqueue(void *data);
+static eos_s8_t eos_event_queue_topic(eos_topic_t topic);
 #endif
 
 // eventos ---------------------------------------------------------------------
 static void eos_clear(void)
 {
 #if (EOS_USE_TIME_EVENT != 0)
+#if (EOS_USE_TIMER_MIN_HEAP != 0)
+    eos_timer_init();
+#else
     eos.timer_count = 0;
 #endif
+#endif
 }
 
 void eos_init(void)
@@ -237,28 +535,101 @@ void eos_init(void)
     eos.running = EOS_False;
     eos.actor_exist = 0;
     eos.actor_enabled = 0;
+#if (EOS_USE_HSM_CACHE != 0)
+    eos_hsm_cache_init();
+#endif
 #if (EOS_USE_PUB_SUB != 0)
     eos.sub_table = EOS_NULL;
+#if (EOS_USE_SUB_CONST != 0)
+    eos.sub_const = EOS_NULL;
+#endif
 #endif
 
 #if (EOS_USE_EVENT_DATA != 0)
+#if (EOS_USE_HEAP_BIN != 0)
+    eos_heap_init_bin(&eos.heap);
+#else
     eos_heap_init(&eos.heap);
 #endif
+#endif
+    eos_ring_init(&eos.ring);
+#if (EOS_USE_PUB_INGRESS != 0)
+    eos_ingress_init(&eos.ingress);
+#endif
+#if (EOS_USE_EVENT_BRIDGE != 0)
+    eos.bridge_tx = EOS_NULL;
+    eos.bridge_rx = EOS_NULL;
+    eos.bridge_count = 0;
+#if (EOS_USE_BRIDGE_STREAM != 0)
+    eos.stream.enabled = EOS_False;
+#endif
+#endif
+    eos.sub_general = 0;
+#if (EOS_USE_SUB_GROUP != 0)
+    eos.sub_group = 0;
+#endif
+    eos.seq = 0;
+    eos.batch = EOS_SIZE_DISPATCH_BATCH;
+    for (eos_u8_t i = 0; i < EOS_MAX_ACTORS; i ++) {
+        eos.pending[i] = 0;
+    }
+#if (EOS_USE_MULTI_WORKER != 0)
+    for (eos_u8_t i = 0; i < EOS_MAX_WORKERS; i ++) {
+        eos.worker_mask[i] = 0;
+    }
+    eos.sub_busy = 0;
+    eos.worker_num = 1;
+    eos.steal = EOS_False;
+#endif
+#if (EOS_USE_PREEMPT != 0)
+    eos.prio_run = 0;
+#endif
 
     eos.init_end = 1;
 #if (EOS_USE_TIME_EVENT != 0)
     eos.time = 0;
+    eos.sub_delay = 0;
+    eos.sub_block = 0;
+    eos.delay_min = EOS_U32_MAX;
+    eos.unblocked_count = 0;
+    EOS_ACTOR_RUN = EOS_MAX_ACTORS;
 #endif
 }
 
 #if (EOS_USE_PUB_SUB != 0)
-void eos_sub_init(eos_mcu_t *flag_sub, eos_topic_t topic_max)
+void eos_sub_init(eos_sub_t *flag_sub, eos_topic_t topic_max)
 {
+#if (EOS_USE_SUB_CONST != 0)
+    // 作为编译期订阅表的叠加层时，二者的主题范围相同
+    EOS_ASSERT(eos.sub_const == EOS_NULL || eos.topic_max == topic_max);
+#endif
     eos.sub_table = flag_sub;
+    eos.topic_max = topic_max;
     for (int i = 0; i < topic_max; i ++) {
         eos.sub_table[i] = 0;
     }
 }
+
+#if (EOS_USE_SUB_CONST != 0)
+void eos_sub_init_const(eos_sub_t const *table, eos_topic_t topic_max)
+{
+    EOS_ASSERT(table != EOS_NULL);
+    EOS_ASSERT(eos.sub_table == EOS_NULL || eos.topic_max == topic_max);
+
+    eos.sub_const = table;
+    eos.topic_max = topic_max;
+}
+
+static eos_sub_t eos_sub_read(eos_topic_t topic)
+{
+    eos_sub_t sub = (eos.sub_const != EOS_NULL) ? eos.sub_const[topic] : 0;
+    if (eos.sub_table != EOS_NULL) {
+        sub |= eos.sub_table[topic];
+    }
+
+    return sub;
+}
+#endif
 #endif
 
 #if (EOS_USE_TIME_EVENT != 0)
@@ -267,6 +638,48 @@ eos_s32_t eos_evttimer(void)
     // 获取当前时间，检查延时事件队列
     eos_u32_t system_time = eos.time;
     
+#if (EOS_USE_TIMER_MIN_HEAP != 0)
+    if (eos.timer_count == 0)
+        return EosTimer_Empty;
+
+    // 时间未到达
+    if (system_time < eos.timeout_min)
+        return EosTimer_NotTimeout;
+    // 到期的定时器依次从堆顶取出。周期定时器更新超时时间后，暂存在堆之后，
+    // 与数组实现一致，每个定时器每次最多触发一次。
+    while (eos.timer_heap_size != 0 &&
+           eos.etimer[eos.timer_heap[0]].timeout_ms <= system_time) {
+        eos_u16_t index = eos.timer_heap[0];
+        eos_event_pub_topic(eos.etimer[index].topic);
+        if (eos.etimer[index].oneshoot == EOS_True) {
+            eos_timer_remove(index);
+        }
+        else {
+            eos_u32_t period = eos.etimer[index].period * timer_unit[eos.etimer[index].unit];
+            eos.etimer[index].timeout_ms += period;
+            eos_u16_t tail = -- eos.timer_heap_size;
+            eos.timer_heap[0] = eos.timer_heap[tail];
+            eos.timer_pos[eos.timer_heap[0]] = 0;
+            eos.timer_heap[tail] = index;
+            eos.timer_pos[index] = tail;
+            if (tail != 0) {
+                eos_timer_sift_down(0);
+            }
+        }
+    }
+    // 暂存的周期定时器重新入堆
+    while (eos.timer_heap_size < eos.timer_count) {
+        eos.timer_heap_size ++;
+        eos_timer_sift_up(eos.timer_heap_size - 1);
+    }
+    if (eos.timer_count == 0) {
+        eos.timeout_min = EOS_U32_MAX;
+        return EosTimer_ChangeToEmpty;
+    }
+    eos.timeout_min = eos.etimer[eos.timer_heap[0]].timeout_ms;
+
+    return EosRun_OK;
+#else
     if (eos.etimer[0].topic == Event_Null)
         return EosTimer_Empty;
 
@@ -308,17 +721,41 @@ eos_s32_t eos_evttimer(void)
     eos.timeout_min = min_time_out_ms;
 
     return EosRun_OK;
+#endif
 }
 #endif
 
 eos_s8_t eos_once(void)
+{
+    return eos_schedule(0, EOS_SUB_ALL);
+}
+
+#if (EOS_USE_MULTI_WORKER != 0)
+eos_s8_t eos_worker_once(eos_u8_t worker)
+{
+    EOS_ASSERT(worker < EOS_MAX_WORKERS);
+
+    eos_s8_t ret = eos_schedule(worker, eos.worker_mask[worker]);
+#if (EOS_USE_WORK_STEALING != 0)
+    // 自己的Actor都没有可分发的事件时，窃取其他worker的就绪Actor
+    if (ret == (eos_s8_t)EosRun_NoEvent && eos.steal != EOS_False) {
+        ret = eos_schedule(worker, ~eos.worker_mask[worker]);
+    }
+#endif
+
+    return ret;
+}
+#endif
+
+// 调度一次，只分发mask中的Actor的事件。时间事件只由worker 0处理。
+static eos_s8_t eos_schedule(eos_u8_t worker, eos_sub_t mask)
 {
     if (eos.init_end == 0) {
         return (eos_s8_t)EosRunErr_NotInitEnd;
     }
 
 #if (EOS_USE_PUB_SUB != 0)
-    if (eos.sub_table == EOS_NULL) {
+    if (EOS_SUB_NONE()) {
         return (eos_s8_t)EosRunErr_SubTableNull;
     }
 #endif
@@ -333,46 +770,145 @@ eos_s8_t eos_once(void)
         return (eos_s8_t)EosRun_NoActor;
     }
 
+    EOS_WORKER_LOCK();
 #if (EOS_USE_TIME_EVENT != 0)
-    eos_evttimer();
+    if (worker == 0) {
+        eos_evttimer();
+        eos_delay_check();
+    }
+#endif
+#if (EOS_USE_PUB_INGRESS != 0)
+    eos_ingress_drain();
+#endif
+#if (EOS_USE_EVENT_BRIDGE != 0)
+    if (worker == 0) {
+        eos_bridge_poll();
+    }
+#endif
+    EOS_WORKER_UNLOCK();
+#if (EOS_USE_BRIDGE_STREAM != 0)
+    // 上一轮调度中转发的事件，合为一帧发送
+    if (worker == 0) {
+        eos_bridge_flush();
+    }
 #endif
+    (void)worker;
 
-    if (eos.heap.empty == EOS_True) {
+    if ((eos.sub_general & mask) == 0) {
         return (eos_s8_t)EosRun_NoEvent;
     }
 
-    // 寻找到优先级最高，且有事件需要处理的Actor
-    eos_actor_t *actor = eos.actor[0];
+    // 分发优先级最高的Actor的事件
     eos_u8_t priority = EOS_MAX_ACTORS;
-    for (eos_s8_t i = (eos_s8_t)(EOS_MAX_ACTORS - 1); i >= 0; i --) {
-        if ((eos.actor_exist & (1 << i)) == 0)
-            continue;
-        if ((eos.heap.sub_general & (1 << i)) == 0)
-            continue;
-        actor = eos.actor[i];
-        priority = i;
-        break;
-    }
-    // 如果没有找到，返回
-    if (priority == EOS_MAX_ACTORS) {
-        return (eos_s8_t)EosRun_NoActorSub;
+    eos_s8_t ret = eos_dispatch(&priority, mask);
+    // 批量模式，连续分发该Actor的事件，直到其事件取完或有更高优先级的Actor就绪
+    for (eos_u8_t n = 1; n < eos.batch && ret == (eos_s8_t)EosRun_OK; n ++) {
+#if (EOS_USE_PUB_INGRESS != 0)
+        // 处理过程中发布的事件，可能使更高优先级的Actor就绪
+        EOS_WORKER_LOCK();
+        eos_ingress_drain();
+        EOS_WORKER_UNLOCK();
+#endif
+        ret = eos_dispatch(&priority, mask);
+        if (ret == (eos_s8_t)EosRun_NoEvent) {
+            return (eos_s8_t)EosRun_OK;
+        }
     }
 
-    // 寻找当前Actor的最老的事件
+    return ret;
+}
+
+// 取出mask中的一个事件并分发。priority为EOS_MAX_ACTORS时，选择mask中优先级最高的就绪
+// Actor，并将其写回；否则仅在该Actor依然是优先级最高的就绪Actor时分发，不然返回
+// EosRun_NoEvent。多线程调度时，正在其他worker中运行的Actor不参与选择。
+static eos_s8_t eos_dispatch(eos_u8_t *priority_, eos_sub_t mask)
+{
+    eos_event_t event;
     eos_port_critical_enter();
-    eos_event_inner_t * e = eos_heap_get_block(&eos.heap, priority);
-    EOS_ASSERT(e != EOS_NULL);
+    eos_sub_t ready = eos.sub_general & mask;
+#if (EOS_USE_MULTI_WORKER != 0)
+    ready &= ~eos.sub_busy;
+#endif
+#if (EOS_USE_TIME_EVENT != 0)
+    // 延时中的Actor不参与选择，其事件保留在队列中
+    ready &= ~eos.sub_delay;
+#endif
+    if (ready == 0) {
+        eos_port_critical_exit();
+        return (eos_s8_t)EosRun_NoEvent;
+    }
+#if (EOS_USE_MULTI_WORKER != 0)
+    eos_u8_t priority = eos_sub_highest(ready);
+#else
+    eos_u8_t priority = (ready == eos.sub_general) ?
+                        eos_ready_highest() : eos_sub_highest(ready);
+#endif
+    if (*priority_ != EOS_MAX_ACTORS && *priority_ != priority) {
+        eos_port_critical_exit();
+        return (eos_s8_t)EosRun_NoEvent;
+    }
+    *priority_ = priority;
+#if (EOS_USE_MULTI_WORKER != 0)
+    eos.sub_busy |= EOS_SUB_BIT(priority);
+#endif
+#if (EOS_USE_TIME_EVENT != 0)
+    eos_u8_t actor_run = EOS_ACTOR_RUN;
+    EOS_ACTOR_RUN = priority;
+#endif
+#if (EOS_USE_PREEMPT != 0)
+    // 运行期间，只有优先级更高的Actor可以抢占
+    eos_u8_t prio_run = eos.prio_run;
+    if (eos.prio_run <= priority) {
+        eos.prio_run = priority + 1;
+    }
+#endif
+    eos_actor_t *actor = eos.actor[priority];
+    EOS_ASSERT((eos.actor_exist & EOS_SUB_BIT(priority)) != 0);
 
+    // 寻找当前Actor的最老的事件，在Ring与Heap之间按发布顺序选取
+    eos_event_record_t *r = eos_ring_find(&eos.ring, priority);
+#if (EOS_USE_EVENT_DATA != 0)
+    eos_event_inner_t * e = eos_heap_find(&eos.heap, priority);
+    if (e != EOS_NULL && r != EOS_NULL && (eos_s32_t)(r->seq - e->seq) < 0) {
+        e = EOS_NULL;
+    }
+    if (e != EOS_NULL) {
+        e->sub &=~ EOS_SUB_BIT(priority);
+#if (EOS_USE_EVENT_REF != 0)
+        // 分发期间持有事件，防止在事件处理函数中被eos_event_unref释放
+        e->ref ++;
+#endif
+        event.topic = e->topic;
+        event.data = (void *)((eos_pointer_t)e + sizeof(eos_event_inner_t));
+        eos_block_t *block = (eos_block_t *)((eos_pointer_t)e - sizeof(eos_block_t));
+        event.size = block->size - block->offset - sizeof(eos_event_inner_t);
+    }
+    else
+#endif
+    {
+        EOS_ASSERT(r != EOS_NULL);
+        event.topic = r->topic;
+        event.data = EOS_NULL;
+        event.size = 0;
+        eos_ring_take(&eos.ring, r, priority);
+    }
+    // 该Actor的事件已全部取出，清除其就绪位
+    EOS_ASSERT(eos.pending[priority] != 0);
+    eos.pending[priority] --;
+    if (eos.pending[priority] == 0) {
+        eos.sub_general &= ~EOS_SUB_BIT(priority);
+#if (EOS_USE_SUB_GROUP != 0)
+        if ((eos_u8_t)(eos.sub_general >> (priority & 0xf8)) == 0) {
+            eos.sub_group &= ~(1 << (priority >> 3));
+        }
+#endif
+    }
     eos_port_critical_exit();
-    eos_event_t event;
-    event.topic = e->topic;
-    event.data = (void *)((eos_pointer_t)e + sizeof(eos_event_inner_t));
-    eos_block_t *block = (eos_block_t *)((eos_pointer_t)e - sizeof(eos_block_t));
-    event.size = block->size - block->offset - sizeof(eos_event_inner_t);
 
     // 对事件进行执行
+    eos_s8_t ret = (eos_s8_t)EosRun_OK;
 #if (EOS_USE_PUB_SUB != 0)
-    if ((eos.sub_table[e->topic] & (1 << actor->priority)) != 0)
+    if ((EOS_SUB_READ(event.topic) & EOS_SUB_BIT(actor->priority)) != 0)
 #endif
     {
 #if (EOS_USE_SM_MODE != 0)
@@ -390,17 +926,35 @@ eos_s8_t eos_once(void)
     }
 #if (EOS_USE_PUB_SUB != 0)
     else {
-        return (eos_s8_t)EosRunErr_ActorNotSub;
+        ret = (eos_s8_t)EosRunErr_ActorNotSub;
     }
 #endif
 #if (EOS_USE_EVENT_DATA != 0)
-    // 销毁过期事件与其携带的参数
+    // 销毁过期事件与其携带的参数（即使未被处理）
+    if (e != EOS_NULL) {
+        eos_port_critical_enter();
+#if (EOS_USE_EVENT_REF != 0)
+        e->ref --;
+#endif
+        eos_heap_gc(&eos.heap, e);
+        eos_port_critical_exit();
+    }
+#endif
+#if (EOS_USE_MULTI_WORKER != 0 || EOS_USE_PREEMPT != 0)
     eos_port_critical_enter();
-    eos_heap_gc(&eos.heap, e);
+#if (EOS_USE_MULTI_WORKER != 0)
+    eos.sub_busy &= ~EOS_SUB_BIT(priority);
+#endif
+#if (EOS_USE_PREEMPT != 0)
+    eos.prio_run = prio_run;
+#endif
     eos_port_critical_exit();
 #endif
+#if (EOS_USE_TIME_EVENT != 0)
+    EOS_ACTOR_RUN = actor_run;
+#endif
 
-    return (eos_s8_t)EosRun_OK;
+    return ret;
 }
 
 void eos_run(void)
@@ -409,7 +963,7 @@ void eos_run(void)
 
     EOS_ASSERT(eos.enabled == EOS_True);
 #if (EOS_USE_PUB_SUB != 0)
-    EOS_ASSERT(eos.sub_table != 0);
+    EOS_ASSERT(!EOS_SUB_NONE());
 #endif
 #if (EOS_USE_EVENT_DATA != 0 && EOS_USE_HEAP != 0)
     EOS_ASSERT(eos.heap.size != 0);
@@ -418,7 +972,11 @@ void eos_run(void)
     eos.running = EOS_True;
 
     while (eos.enabled) {
+#if (EOS_USE_MULTI_WORKER != 0)
+        eos_s8_t ret = eos_worker_once(0);
+#else
         eos_s8_t ret = eos_once();
+#endif
         EOS_ASSERT(ret >= 0);
 
         if (ret == EosRun_NotEnabled) {
@@ -427,10 +985,12 @@ void eos_run(void)
 
         if (ret == EosRun_NoActor || ret == EosRun_NoEvent) {
 #if (EOS_USE_MAGIC != 0)
+#if (EOS_USE_EVENT_DATA != 0)
             EOS_ASSERT(eos.heap.magic == EOS_MAGIC_NUMBER);
+#endif
             EOS_ASSERT(eos.magic == EOS_MAGIC_NUMBER);
             for (eos_u8_t i = 0; i < EOS_MAX_ACTORS; i ++) {
-                if ((eos.actor_exist & (1 << i)) != 0) {
+                if ((eos.actor_exist & EOS_SUB_BIT(i)) != 0) {
                     EOS_ASSERT(eos.actor[i]->magic == EOS_MAGIC_NUMBER);
                 }
             }
@@ -444,84 +1004,298 @@ void eos_run(void)
     }
 }
 
-void eos_stop(void)
+#if (EOS_USE_MULTI_WORKER != 0)
+void eos_worker_bind(eos_actor_t * const me, eos_u8_t worker)
 {
-    eos.enabled = EOS_False;
-    eos_hook_stop();
+    EOS_ASSERT(eos.running == EOS_False);
+    EOS_ASSERT(worker < EOS_MAX_WORKERS);
+    EOS_ASSERT((eos.actor_exist & EOS_SUB_BIT(me->priority)) != 0);
+
+    eos.worker_num = 1;
+    for (eos_u8_t i = 0; i < EOS_MAX_WORKERS; i ++) {
+        eos.worker_mask[i] &= ~EOS_SUB_BIT(me->priority);
+        if (i == worker) {
+            eos.worker_mask[i] |= EOS_SUB_BIT(me->priority);
+        }
+        if (eos.worker_mask[i] != 0) {
+            eos.worker_num = i + 1;
+        }
+    }
 }
 
-#if (EOS_USE_TIME_EVENT != 0)
-eos_u32_t eos_time(void)
+#if (EOS_USE_WORK_STEALING != 0)
+void eos_worker_steal(eos_u8_t worker_num)
 {
-    return eos.time;
+    EOS_ASSERT(eos.running == EOS_False);
+    EOS_ASSERT(worker_num >= eos.worker_num && worker_num <= EOS_MAX_WORKERS);
+
+    eos.worker_num = worker_num;
+    eos.steal = EOS_True;
 }
+#endif
 
-void eos_tick(void)
+eos_u8_t eos_worker_num(void)
 {
-    eos_u32_t system_time = eos.time, system_time_bkp = eos.time;
-    eos_u32_t offset = EOS_MS_NUM_30DAY - 1 + EOS_TICK_MS;
-    system_time = ((system_time + EOS_TICK_MS) % EOS_MS_NUM_30DAY);
-    if (system_time_bkp >= (EOS_MS_NUM_30DAY - EOS_TICK_MS) && system_time < EOS_TICK_MS) {
-        eos_port_critical_enter();
-        EOS_ASSERT(eos.timeout_min >= offset);
-        eos.timeout_min -= offset;
-        for (eos_u32_t i = 0; i < eos.timer_count; i ++) {
-            EOS_ASSERT(eos.etimer[i].timeout_ms >= offset);
-            eos.etimer[i].timeout_ms -= offset;
+    return eos.worker_num;
+}
+
+void eos_worker_run(eos_u8_t worker)
+{
+    EOS_ASSERT(worker != 0 && worker < EOS_MAX_WORKERS);
+
+    while (eos.enabled) {
+        eos_s8_t ret = eos_worker_once(worker);
+        EOS_ASSERT(ret >= 0);
+
+        if (ret == EosRun_NotEnabled) {
+            break;
+        }
+
+        if (ret == EosRun_NoActor || ret == EosRun_NoEvent) {
+            eos_hook_idle();
         }
-        eos_port_critical_exit();
     }
-    eos.time = system_time;
 }
 #endif
 
-// 关于Reactor -----------------------------------------------------------------
-static void eos_actor_init( eos_actor_t * const me,
-                            eos_u8_t priority,
-                            void const * const parameter)
+#if (EOS_USE_PREEMPT != 0)
+void eos_preempt(void)
 {
-    (void)parameter;
+    if (eos.init_end == 0 || eos.enabled == EOS_False) {
+        return;
+    }
+    // 没有Actor在运行时，由调度器正常分发
+    if (eos.prio_run == 0 || EOS_PREEMPT_ENABLED() == 0) {
+        return;
+    }
 
-    // 框架需要先启动起来
-    EOS_ASSERT(eos.enabled == EOS_True);
-    EOS_ASSERT(eos.running == EOS_False);
-#if (EOS_USE_PUB_SUB != 0)
-    EOS_ASSERT(eos.sub_table != EOS_NULL);
+#if (EOS_USE_PUB_INGRESS != 0)
+    eos_ingress_drain();
 #endif
-    // 参数检查
-    EOS_ASSERT(me != (eos_actor_t *)0);
-    EOS_ASSERT(priority < EOS_MAX_ACTORS);
+    // 分发优先级高于当前运行的Actor的全部事件，之后返回被抢占的Actor
+    eos_s8_t ret;
+    do {
+        eos_u8_t priority = EOS_MAX_ACTORS;
+        ret = eos_dispatch(&priority, eos_sub_above(eos.prio_run));
+    } while (ret != (eos_s8_t)EosRun_NoEvent);
+}
 
-    // 防止二次启动
-    if (me->enabled == EOS_True)
-        return;
+eos_u8_t eos_lock(eos_u8_t ceiling)
+{
+    EOS_ASSERT(ceiling < EOS_MAX_ACTORS);
 
-    // 检查优先级的重复注册
-    EOS_ASSERT((eos.actor_exist & (1 << priority)) == 0);
+    eos_port_critical_enter();
+    eos_u8_t prev = eos.prio_run;
+    if (eos.prio_run <= ceiling) {
+        eos.prio_run = ceiling + 1;
+    }
+    eos_port_critical_exit();
 
-    // 注册到框架里
-    eos.actor_exist |= (1 << priority);
-    eos.actor[priority] = me;
-    // 状态机   
-    me->priority = priority;
-#if (EOS_USE_MAGIC != 0)
-    me->magic = EOS_MAGIC_NUMBER;
-#endif
+    return prev;
 }
 
-void eos_reactor_init(  eos_reactor_t * const me,
-                        eos_u8_t priority,
-                        void const * const parameter)
+void eos_unlock(eos_u8_t prev)
 {
-    eos_actor_init(&me->super, priority, parameter);
-    me->super.mode = EOS_Mode_Reactor;
+    eos_port_critical_enter();
+    eos.prio_run = prev;
+    // 加锁期间就绪的、被天花板阻挡的Actor
+    eos_preempt_check(eos.sub_general);
+    eos_port_critical_exit();
 }
+#endif
 
-void eos_reactor_start(eos_reactor_t * const me, eos_event_handler event_handler)
+void eos_stop(void)
+{
+    eos.enabled = EOS_False;
+    eos_hook_stop();
+#if (EOS_USE_IDLE_WAKEUP != 0)
+    eos_port_wakeup();
+#endif
+}
+
+#if (EOS_USE_TIME_EVENT != 0)
+eos_u32_t eos_time(void)
+{
+    return eos.time;
+}
+
+// 当前线程中正在运行的Actor的优先级，没有时为EOS_MAX_ACTORS
+eos_u8_t eos_actor_current(void)
+{
+    return EOS_ACTOR_RUN;
+}
+
+void eos_tick(void)
+{
+    eos_tick_advance(EOS_TICK_MS);
+}
+
+void eos_tick_advance(eos_u32_t elapsed_ms)
+{
+    EOS_ASSERT(elapsed_ms < EOS_MS_NUM_30DAY);
+
+    // eos.time与elapsed_ms都可接近30天，二者之和会超出32位，因此先与到回绕点的剩余时间
+    // 比较，跨越回绕点时只加上越过的部分。
+    eos_u32_t remain = EOS_MS_NUM_30DAY - eos.time;
+    eos_u32_t system_time;
+    if (elapsed_ms < remain) {
+        system_time = eos.time + elapsed_ms;
+    }
+    else {
+        // 时间回绕，所有定时器统一前移30天。跨越回绕点时已经到期却尚未处理的定时器，
+        // 其超时时间记为0，在下次检查时立即触发。统一的单调变换不影响最小堆的堆序。
+        system_time = elapsed_ms - remain;
+        eos_port_critical_enter();
+        if (eos.timeout_min != EOS_U32_MAX) {
+            eos.timeout_min = (eos.timeout_min >= EOS_MS_NUM_30DAY) ?
+                              (eos.timeout_min - EOS_MS_NUM_30DAY) : 0;
+        }
+        for (eos_u32_t i = 0; i < eos.timer_count; i ++) {
+            eos.etimer[i].timeout_ms =
+                (eos.etimer[i].timeout_ms >= EOS_MS_NUM_30DAY) ?
+                (eos.etimer[i].timeout_ms - EOS_MS_NUM_30DAY) : 0;
+        }
+        if (eos.sub_delay != 0) {
+            eos.delay_min = (eos.delay_min >= EOS_MS_NUM_30DAY) ?
+                            (eos.delay_min - EOS_MS_NUM_30DAY) : 0;
+        }
+        for (eos_u8_t i = 0; i < EOS_MAX_ACTORS; i ++) {
+            if ((eos.sub_delay & EOS_SUB_BIT(i)) != 0) {
+                eos.delay_ms[i] = (eos.delay_ms[i] >= EOS_MS_NUM_30DAY) ?
+                                  (eos.delay_ms[i] - EOS_MS_NUM_30DAY) : 0;
+            }
+        }
+        eos_port_critical_exit();
+    }
+    eos.time = system_time;
+}
+
+eos_u32_t eos_time_next(void)
+{
+    eos_u32_t timeout = (eos.timer_count == 0) ? EOS_U32_MAX : eos.timeout_min;
+    // 延时中的Actor也需要按时恢复
+    if (eos.sub_delay != 0 && eos.delay_min < timeout) {
+        timeout = eos.delay_min;
+    }
+    if (timeout == EOS_U32_MAX) {
+        return EOS_TIME_FOREVER;
+    }
+    if (timeout <= eos.time) {
+        return 0;
+    }
+
+    return (timeout - eos.time);
+}
+
+void eos_delay(eos_u32_t time_ms)
+{
+    eos_delay_start(time_ms, EOS_False);
+}
+
+void eos_delay_unsub_event(eos_u32_t time_ms)
+{
+    eos_delay_start(time_ms, EOS_True);
+}
+
+// 只记录延时，由调度器在延时期间跳过该Actor
+static void eos_delay_start(eos_u32_t time_ms, eos_bool_t block)
+{
+    EOS_ASSERT(time_ms <= timer_threshold[EosTimerUnit_Minute]);
+
+    eos_port_critical_enter();
+    eos_u8_t priority = EOS_ACTOR_RUN;
+    // 只能在事件处理函数中调用
+    EOS_ASSERT(priority < EOS_MAX_ACTORS);
+    eos.sub_delay |= EOS_SUB_BIT(priority);
+    if (block == EOS_True) {
+        eos.sub_block |= EOS_SUB_BIT(priority);
+    }
+    else {
+        eos.sub_block &= ~EOS_SUB_BIT(priority);
+    }
+    eos.delay_ms[priority] = eos.time + time_ms;
+    if (eos.delay_ms[priority] < eos.delay_min) {
+        eos.delay_min = eos.delay_ms[priority];
+    }
+    eos_port_critical_exit();
+}
+
+// 恢复延时完毕的Actor，只由worker 0在调度时调用
+static void eos_delay_check(void)
+{
+    if (eos.sub_delay == 0 || eos.time < eos.delay_min) {
+        return;
+    }
+
+    eos_port_critical_enter();
+    eos_u32_t delay_min = EOS_U32_MAX;
+    eos_sub_t sub = eos.sub_delay;
+    while (sub != 0) {
+        eos_u8_t i = eos_sub_highest(sub);
+        sub &= ~EOS_SUB_BIT(i);
+        if (eos.delay_ms[i] <= eos.time) {
+            eos.sub_delay &= ~EOS_SUB_BIT(i);
+            eos.sub_block &= ~EOS_SUB_BIT(i);
+        }
+        else if (eos.delay_ms[i] < delay_min) {
+            delay_min = eos.delay_ms[i];
+        }
+    }
+    eos.delay_min = delay_min;
+    eos_port_critical_exit();
+}
+#endif
+
+// 关于Reactor -----------------------------------------------------------------
+static void eos_actor_init( eos_actor_t * const me,
+                            eos_u8_t priority,
+                            void const * const parameter)
+{
+    (void)parameter;
+
+    // 框架需要先启动起来
+    EOS_ASSERT(eos.enabled == EOS_True);
+    EOS_ASSERT(eos.running == EOS_False);
+#if (EOS_USE_PUB_SUB != 0)
+    EOS_ASSERT(!EOS_SUB_NONE());
+#endif
+    // 参数检查
+    EOS_ASSERT(me != (eos_actor_t *)0);
+    EOS_ASSERT(priority < EOS_MAX_ACTORS);
+
+    // 防止二次启动
+    if (me->enabled == EOS_True)
+        return;
+
+    // 检查优先级的重复注册
+    EOS_ASSERT((eos.actor_exist & EOS_SUB_BIT(priority)) == 0);
+
+    // 注册到框架里
+    eos.actor_exist |= EOS_SUB_BIT(priority);
+    eos.actor[priority] = me;
+#if (EOS_USE_MULTI_WORKER != 0)
+    eos.worker_mask[0] |= EOS_SUB_BIT(priority);
+#endif
+    // 状态机   
+    me->priority = priority;
+#if (EOS_USE_MAGIC != 0)
+    me->magic = EOS_MAGIC_NUMBER;
+#endif
+}
+
+void eos_reactor_init(  eos_reactor_t * const me,
+                        eos_u8_t priority,
+                        void const * const parameter)
+{
+    eos_actor_init(&me->super, priority, parameter);
+    me->super.mode = EOS_Mode_Reactor;
+}
+
+void eos_reactor_start(eos_reactor_t * const me, eos_event_handler event_handler)
 {
     me->event_handler = event_handler;
     me->super.enabled = EOS_True;
-    eos.actor_enabled |= (1 << me->super.priority);
+    eos.actor_enabled |= EOS_SUB_BIT(me->super.priority);
 }
 
 // state machine ---------------------------------------------------------------
@@ -533,18 +1307,25 @@ void eos_sm_init(   eos_sm_t * const me,
     eos_actor_init(&me->super, priority, parameter);
     me->super.mode = EOS_Mode_StateMachine;
     me->state = eos_state_top;
+#if (EOS_USE_HSM_TRAN_CACHE != 0)
+    me->tran_count = 0;
+    me->tran_next = 0;
+#endif
+#if (EOS_USE_HSM_HISTORY != 0)
+    me->history_count = 0;
+#endif
 }
 
 void eos_sm_start(eos_sm_t * const me, eos_state_handler state_init)
 {
-#if (EOS_USE_HSM_MODE != 0)
+#if (EOS_USE_HSM_MODE != 0 && EOS_USE_HSM_CACHE == 0)
     eos_state_handler path[EOS_MAX_HSM_NEST_DEPTH];
 #endif
     eos_state_handler t;
 
     me->state = state_init;
     me->super.enabled = EOS_True;
-    eos.actor_enabled |= (1 << me->super.priority);
+    eos.actor_enabled |= EOS_SUB_BIT(me->super.priority);
 
     // 进入初始状态，执行TRAN动作。这也意味着，进入初始状态，必须无条件执行Tran动作。
     t = me->state;
@@ -553,6 +1334,10 @@ void eos_sm_start(eos_sm_t * const me, eos_state_handler state_init)
 #if (EOS_USE_HSM_MODE == 0)
     ret = me->state(me, &eos_event_table[Event_Enter]);
     EOS_ASSERT(ret != EOS_Ret_Tran);
+#elif (EOS_USE_HSM_CACHE != 0)
+    t = me->state;
+    eos_hsm_enter(me, eos_hsm_node(me, eos_state_top), eos_hsm_node(me, t));
+    eos_hsm_drill(me, t);
 #else
     t = eos_state_top;
     // 由初始状态转移，引发的各层状态的进入
@@ -587,15 +1372,78 @@ void eos_sm_start(eos_sm_t * const me, eos_state_handler state_init)
 }
 #endif
 
+// table-driven fsm ------------------------------------------------------------
+#if (EOS_USE_FSM_TABLE != 0)
+static const eos_event_t eos_fsm_event_start = { Event_Null, EOS_NULL, 0 };
+
+static void eos_fsm_dispatch(eos_reactor_t * const reactor, eos_event_t const * const e)
+{
+    eos_fsm_t *me = (eos_fsm_t *)reactor;
+    eos_fsm_table_t const *table = me->table;
+
+    // 系统事件与表外的主题，回绕后都不小于topic_num
+    eos_topic_t column = (eos_topic_t)(e->topic - Event_User);
+    if (column >= table->topic_num) {
+        return;
+    }
+    eos_fsm_tran_t const *tran = &table->tran[me->state * table->topic_num + column];
+    if (tran->action != EOS_NULL) {
+        tran->action(me, e);
+    }
+    if (tran->target == 0) {
+        return;
+    }
+
+    // 外部转换，自身转换也退出并重新进入
+    eos_u8_t target = tran->target - 1;
+    EOS_ASSERT(target < table->state_num);
+    if (table->state != EOS_NULL) {
+        if (table->state[me->state].exit != EOS_NULL) {
+            table->state[me->state].exit(me, e);
+        }
+        me->state = target;
+        if (table->state[target].enter != EOS_NULL) {
+            table->state[target].enter(me, e);
+        }
+    }
+    else {
+        me->state = target;
+    }
+}
+
+void eos_fsm_init(eos_fsm_t * const me, eos_u8_t priority, eos_fsm_table_t const * const table)
+{
+    EOS_ASSERT(table != EOS_NULL && table->tran != EOS_NULL);
+    EOS_ASSERT(table->state_num != 0 && table->state_num < 0xff);
+
+    eos_reactor_init(&me->super, priority, EOS_NULL);
+    me->table = table;
+    me->state = 0;
+}
+
+void eos_fsm_start(eos_fsm_t * const me, eos_u8_t state_init)
+{
+    eos_fsm_table_t const *table = me->table;
+
+    EOS_ASSERT(state_init < table->state_num);
+
+    me->state = state_init;
+    if (table->state != EOS_NULL && table->state[state_init].enter != EOS_NULL) {
+        table->state[state_init].enter(me, &eos_fsm_event_start);
+    }
+    eos_reactor_start(&me->super, eos_fsm_dispatch);
+}
+#endif
+
 // event -----------------------------------------------------------------------
-eos_s8_t eos_event_pub_ret(eos_topic_t topic, void *data, eos_u32_t size)
+static eos_s8_t eos_event_check(eos_topic_t topic)
 {
     if (eos.init_end == 0) {
         return (eos_s8_t)EosRunErr_NotInitEnd;
     }
 
 #if (EOS_USE_PUB_SUB != 0)
-    if (eos.sub_table == EOS_NULL) {
+    if (EOS_SUB_NONE()) {
         return (eos_s8_t)EosRunErr_SubTableNull;
     }
 #endif
@@ -615,114 +1463,387 @@ eos_s8_t eos_event_pub_ret(eos_topic_t topic, void *data, eos_u32_t size)
     }
     // 没有状态机订阅，返回
 #if (EOS_USE_PUB_SUB != 0)
-    if (eos.sub_table[topic] == 0) {
+    if (EOS_SUB_READ(topic) == 0) {
         return (eos_s8_t)EosRun_NoActorSub;
     }
+#else
+    (void)topic;
 #endif
 
-    eos_port_critical_enter();
-    // 申请事件空间
-    eos_event_inner_t *e = eos_heap_malloc(&eos.heap, (size + sizeof(eos_event_inner_t)));
-    if (e == (eos_event_inner_t *)0) {
-        eos_port_critical_exit();
-        return (eos_s8_t)EosRunErr_MallocFail;
-    }
-    e->topic = topic;
+    return (eos_s8_t)EosRun_OK;
+}
+
+static eos_sub_t eos_event_sub_get(eos_topic_t topic)
+{
 #if (EOS_USE_PUB_SUB != 0)
-    e->sub = eos.sub_table[e->topic];
+    eos_sub_t sub = EOS_SUB_READ(topic);
 #else
-    e->sub = eos.actor_exist;
+    eos_sub_t sub = eos.actor_exist;
 #endif
-    eos.heap.sub_general |= e->sub;
-    eos_u8_t *e_data = (eos_u8_t *)e + sizeof(eos_event_inner_t);
-    for (eos_u32_t i = 0; i < size; i ++) {
-        e_data[i] = ((eos_u8_t *)data)[i];
+#if (EOS_USE_TIME_EVENT != 0)
+    // 屏蔽事件接收的延时中，只有不可阻塞事件进入该Actor
+    if ((sub & eos.sub_block) != 0 && eos_event_unblocked(topic) == EOS_False) {
+        sub &= ~eos.sub_block;
     }
-    eos_port_critical_exit();
+#endif
 
-    return (eos_s8_t)EosRun_OK;
+    return sub;
 }
 
-void eos_event_pub_topic(eos_topic_t topic)
+#if (EOS_USE_TIME_EVENT != 0)
+static eos_bool_t eos_event_unblocked(eos_topic_t topic)
 {
-    eos_s8_t ret = eos_event_pub_ret(topic, EOS_NULL, 0);
-    EOS_ASSERT(ret >= 0);
-    (void)ret;
+    for (eos_u8_t i = 0; i < eos.unblocked_count; i ++) {
+        if (eos.unblocked[i] == topic) {
+            return EOS_True;
+        }
+    }
+
+    return EOS_False;
 }
 
-#if (EOS_USE_EVENT_DATA != 0)
-void eos_event_pub(eos_topic_t topic, void *data, eos_u32_t size)
+void eos_event_set_unblocked(eos_topic_t topic)
 {
-    eos_s8_t ret = eos_event_pub_ret(topic, data, size);
-    EOS_ASSERT(ret >= 0);
-    (void)ret;
+    if (eos_event_unblocked(topic) == EOS_True) {
+        return;
+    }
+    EOS_ASSERT(eos.unblocked_count < EOS_MAX_UNBLOCKED_TOPIC);
+    eos.unblocked[eos.unblocked_count ++] = topic;
 }
 #endif
 
-#if (EOS_USE_PUB_SUB != 0)
-void eos_event_sub(eos_actor_t * const me, eos_topic_t topic)
+// 事件已经入队，通知订阅的各Actor。需在临界区内调用。
+static void eos_event_ready(eos_sub_t sub)
 {
-    eos.sub_table[topic] |= (1 << me->priority);
+    eos.seq ++;
+    eos.sub_general |= sub;
+#if (EOS_USE_PREEMPT != 0)
+    eos_preempt_check(sub);
+#endif
+    // 只遍历订阅者所在的位
+    while (sub != 0) {
+        eos_u8_t i = eos_sub_highest(sub);
+        sub &= ~EOS_SUB_BIT(i);
+        eos.pending[i] ++;
+#if (EOS_USE_SUB_GROUP != 0)
+        eos.sub_group |= (1 << (i >> 3));
+#endif
+    }
+#if (EOS_USE_IDLE_WAKEUP != 0)
+    // 主循环可能正阻塞在空闲回调中
+    eos_port_wakeup();
+#endif
 }
 
-void eos_event_unsub(eos_actor_t * const me, eos_topic_t topic)
+eos_s8_t eos_event_pub_ret(eos_topic_t topic, void *data, eos_u32_t size)
 {
-    eos.sub_table[topic] &= ~(1 << me->priority);
-}
+#if (EOS_USE_PUB_INGRESS != 0)
+    // 之前经入口环发布的事件排在前面，本地分发与转发到对端都是如此
+    eos_ingress_drain();
 #endif
+#if (EOS_USE_EVENT_BRIDGE != 0)
+    eos_bool_t bridged = eos_bridge_forward(topic, data, size);
+    eos_s8_t ret = eos_event_pub_local(topic, data, size);
+    // 只有对端订阅的事件，对本实例而言不是错误
+    if (bridged == EOS_True && ret == (eos_s8_t)EosRun_NoActorSub) {
+        ret = (eos_s8_t)EosRun_OK;
+    }
 
-#if (EOS_USE_TIME_EVENT != 0)
-void eos_event_pub_time(eos_topic_t topic, eos_u32_t time_ms, eos_bool_t oneshoot)
+    return ret;
+#else
+    return eos_event_pub_local(topic, data, size);
+#endif
+}
+
+// 只发布到本实例
+static eos_s8_t eos_event_pub_local(eos_topic_t topic, void *data, eos_u32_t size)
 {
-    EOS_ASSERT(time_ms != 0);
-    EOS_ASSERT(time_ms <= timer_threshold[EosTimerUnit_Minute]);
-    EOS_ASSERT(eos.timer_count < EOS_MAX_TIME_EVENT);
+    eos_s8_t ret = eos_event_check(topic);
+    if (ret != (eos_s8_t)EosRun_OK) {
+        return ret;
+    }
 
-    // 检查重复，不允许重复发送。
-    for (eos_u32_t i = 0; i < eos.timer_count; i ++) {
-        EOS_ASSERT(topic != eos.etimer[i].topic);
+    // 不携带数据的事件，优先放入Ring，不使用Heap
+    if (size == 0) {
+        eos_port_critical_enter();
+        ret = eos_event_queue_topic(topic);
+        eos_port_critical_exit();
+
+        return ret;
     }
 
-    eos_u32_t system_ms = eos.time;
-    eos_u8_t unit = EosTimerUnit_Ms;
-    eos_u16_t period;
-    for (eos_u8_t i = 0; i < EosTimerUnit_Max; i ++) {
-        if (time_ms > timer_threshold[i])
-            continue;
-        unit = i;
-        
-        if (i == EosTimerUnit_Ms) {
-            period = time_ms;
-            break;
-        }
-        period = (time_ms + (timer_unit[i] >> 1)) / timer_unit[i];
-        break;
+#if (EOS_USE_EVENT_DATA != 0)
+    // 数据的拷贝在临界区之外进行
+    eos_u8_t *e_data = eos_event_alloc(topic, size);
+    if (e_data == EOS_NULL) {
+        return (eos_s8_t)EosRunErr_MallocFail;
     }
-    eos_u32_t timeout = (system_ms + time_ms);
-    eos.etimer[eos.timer_count ++] = (eos_event_timer_t) {
-        topic, oneshoot, unit, period, timeout
-    };
-    
-    if (eos.timeout_min > timeout) {
-        eos.timeout_min = timeout;
+    for (eos_u32_t i = 0; i < size; i ++) {
+        e_data[i] = ((eos_u8_t *)data)[i];
     }
-}
+    eos_event_enqueue(e_data);
 
-void eos_event_pub_delay(eos_topic_t topic, eos_u32_t time_ms)
-{
-    eos_event_pub_time(topic, time_ms, EOS_True);
+    return (eos_s8_t)EosRun_OK;
+#else
+    (void)data;
+    return (size == 0) ?
+            (eos_s8_t)EosRunErr_MallocFail :
+            (eos_s8_t)EosRunErr_InvalidEventData;
+#endif
 }
 
-void eos_event_pub_period(eos_topic_t topic, eos_u32_t time_ms_period)
+// 不携带数据的事件放入Ring，Ring已满时放入Heap。需在临界区内调用。
+static eos_s8_t eos_event_queue_topic(eos_topic_t topic)
 {
-    eos_event_pub_time(topic, time_ms_period, EOS_False);
+    eos_sub_t sub = eos_event_sub_get(topic);
+    // 订阅者都在屏蔽事件接收的延时中，事件被丢弃
+    if (sub == 0) {
+        return (eos_s8_t)EosRun_OK;
+    }
+
+    eos_event_record_t *r = eos_ring_push(&eos.ring);
+    if (r != EOS_NULL) {
+        r->topic = topic;
+        r->sub = sub;
+        r->seq = eos.seq;
+        eos_event_ready(sub);
+
+        return (eos_s8_t)EosRun_OK;
+    }
+
+#if (EOS_USE_EVENT_DATA != 0)
+    eos_event_inner_t *e = eos_heap_reserve(&eos.heap, sizeof(eos_event_inner_t));
+    if (e == EOS_NULL) {
+        return (eos_s8_t)EosRunErr_MallocFail;
+    }
+    e->topic = topic;
+    e->sub = sub;
+    e->seq = eos.seq;
+#if (EOS_USE_EVENT_REF != 0)
+    e->ref = 0;
+#endif
+    eos_heap_commit(&eos.heap, e);
+    eos_event_ready(sub);
+
+    return (eos_s8_t)EosRun_OK;
+#else
+    return (eos_s8_t)EosRunErr_MallocFail;
+#endif
 }
 
-void eos_event_time_cancel(eos_topic_t topic)
+#if (EOS_USE_EVENT_DATA != 0)
+void * eos_event_alloc(eos_topic_t topic, eos_u32_t size)
 {
-    eos_u32_t timeout_min = EOS_U32_MAX;
-    for (eos_u32_t i = 0; i < eos.timer_count; i ++) {
-        if (topic != eos.etimer[i].topic) {
+    if (eos_event_check(topic) != (eos_s8_t)EosRun_OK) {
+        return EOS_NULL;
+    }
+
+    // 临界区内只申请内存，不挂入事件队列
+    eos_port_critical_enter();
+    eos_event_inner_t *e = eos_heap_reserve(&eos.heap, (size + sizeof(eos_event_inner_t)));
+    eos_port_critical_exit();
+    if (e == EOS_NULL) {
+        return EOS_NULL;
+    }
+    e->topic = topic;
+    e->sub = 0;
+#if (EOS_USE_EVENT_REF != 0)
+    e->ref = 0;
+#endif
+
+    return (void *)((eos_pointer_t)e + sizeof(eos_event_inner_t));
+}
+
+#if (EOS_USE_EVENT_REF != 0)
+void * eos_event_ref(eos_event_t const * const e)
+{
+    if (e->data == EOS_NULL) {
+        return EOS_NULL;
+    }
+
+    eos_event_inner_t *inner =
+        (eos_event_inner_t *)((eos_pointer_t)e->data - sizeof(eos_event_inner_t));
+    eos_port_critical_enter();
+    EOS_ASSERT(inner->ref != 0xff);
+    inner->ref ++;
+    eos_port_critical_exit();
+
+    return e->data;
+}
+
+void eos_event_unref(void *data)
+{
+    eos_event_inner_t *e = (eos_event_inner_t *)((eos_pointer_t)data - sizeof(eos_event_inner_t));
+
+    eos_port_critical_enter();
+    EOS_ASSERT(e->ref != 0);
+    e->ref --;
+    // 订阅者均已处理完毕，最后一个持有者负责释放
+    eos_heap_gc(&eos.heap, e);
+    eos_port_critical_exit();
+}
+#endif
+
+void eos_event_commit(void *data)
+{
+#if (EOS_USE_PUB_INGRESS != 0)
+    // 之前经入口环发布的事件排在前面，本地分发与转发到对端都是如此
+    eos_ingress_drain();
+#endif
+#if (EOS_USE_EVENT_BRIDGE != 0)
+    eos_event_inner_t *e = (eos_event_inner_t *)((eos_pointer_t)data - sizeof(eos_event_inner_t));
+    eos_block_t *block = (eos_block_t *)((eos_pointer_t)e - sizeof(eos_block_t));
+    eos_bridge_forward(e->topic, data, block->size - block->offset - sizeof(eos_event_inner_t));
+#endif
+    eos_event_enqueue(data);
+}
+
+// 将事件挂入事件队列，通知订阅者
+static void eos_event_enqueue(void *data)
+{
+    eos_event_inner_t *e = (eos_event_inner_t *)((eos_pointer_t)data - sizeof(eos_event_inner_t));
+
+    eos_port_critical_enter();
+    // 申请之后，订阅者已经全部取消订阅，直接释放
+    eos_sub_t sub = eos_event_sub_get(e->topic);
+    if (sub == 0) {
+        eos_heap_free(&eos.heap, e);
+        eos_port_critical_exit();
+        return;
+    }
+    e->sub = sub;
+    e->seq = eos.seq;
+    eos_heap_commit(&eos.heap, e);
+    eos_event_ready(sub);
+    eos_port_critical_exit();
+}
+#endif
+
+void eos_event_pub_topic(eos_topic_t topic)
+{
+#if (EOS_USE_PUB_INGRESS != 0)
+    // 只写入入口环，不进入临界区，耗时固定，适合在中断与其他线程中调用。
+    // 入口环已满时，退回到常规的发布路径。
+    if (eos_event_check(topic) == (eos_s8_t)EosRun_OK &&
+        eos_ingress_push(&eos.ingress, topic) == EOS_True) {
+#if (EOS_USE_PREEMPT != 0)
+        // 抢占检查读取运行中的优先级，需在临界区内进行
+        eos_port_critical_enter();
+        eos_preempt_check(eos_event_sub_get(topic));
+        eos_port_critical_exit();
+#endif
+#if (EOS_USE_IDLE_WAKEUP != 0)
+        eos_port_wakeup();
+#endif
+        return;
+    }
+#endif
+    eos_s8_t ret = eos_event_pub_ret(topic, EOS_NULL, 0);
+    EOS_ASSERT(ret >= 0);
+    (void)ret;
+}
+
+#if (EOS_USE_EVENT_DATA != 0)
+void eos_event_pub(eos_topic_t topic, void *data, eos_u32_t size)
+{
+    eos_s8_t ret = eos_event_pub_ret(topic, data, size);
+    EOS_ASSERT(ret >= 0);
+    (void)ret;
+}
+#endif
+
+#if (EOS_USE_PUB_SUB != 0)
+void eos_event_sub(eos_actor_t * const me, eos_topic_t topic)
+{
+    // 动态订阅需要运行时的订阅表
+    EOS_ASSERT(eos.sub_table != EOS_NULL);
+    eos.sub_table[topic] |= EOS_SUB_BIT(me->priority);
+}
+
+// 只能取消动态订阅，编译期订阅表中的订阅不受影响
+void eos_event_unsub(eos_actor_t * const me, eos_topic_t topic)
+{
+    EOS_ASSERT(eos.sub_table != EOS_NULL);
+    eos.sub_table[topic] &= ~EOS_SUB_BIT(me->priority);
+}
+#endif
+
+#if (EOS_USE_TIME_EVENT != 0)
+void eos_event_pub_time(eos_topic_t topic, eos_u32_t time_ms, eos_bool_t oneshoot)
+{
+    EOS_ASSERT(time_ms != 0);
+    EOS_ASSERT(time_ms <= timer_threshold[EosTimerUnit_Minute]);
+    EOS_WORKER_LOCK();
+    EOS_ASSERT(eos.timer_count < EOS_MAX_TIME_EVENT);
+
+    // 检查重复，不允许重复发送。
+#if (EOS_USE_TIMER_MIN_HEAP != 0)
+    EOS_ASSERT(eos_timer_find(topic) == EOS_TIMER_NULL);
+#else
+    for (eos_u32_t i = 0; i < eos.timer_count; i ++) {
+        EOS_ASSERT(topic != eos.etimer[i].topic);
+    }
+#endif
+
+    eos_u32_t system_ms = eos.time;
+    eos_u8_t unit = EosTimerUnit_Ms;
+    eos_u16_t period;
+    for (eos_u8_t i = 0; i < EosTimerUnit_Max; i ++) {
+        if (time_ms > timer_threshold[i])
+            continue;
+        unit = i;
+        
+        if (i == EosTimerUnit_Ms) {
+            period = time_ms;
+            break;
+        }
+        period = (time_ms + (timer_unit[i] >> 1)) / timer_unit[i];
+        break;
+    }
+    eos_u32_t timeout = (system_ms + time_ms);
+#if (EOS_USE_TIMER_MIN_HEAP != 0)
+    eos.etimer[eos.timer_count] = (eos_event_timer_t) {
+        topic, oneshoot, unit, period, timeout
+    };
+    eos_timer_add();
+    eos.timeout_min = eos.etimer[eos.timer_heap[0]].timeout_ms;
+#else
+    eos.etimer[eos.timer_count ++] = (eos_event_timer_t) {
+        topic, oneshoot, unit, period, timeout
+    };
+    
+    if (eos.timeout_min > timeout) {
+        eos.timeout_min = timeout;
+    }
+#endif
+    EOS_WORKER_UNLOCK();
+}
+
+void eos_event_pub_delay(eos_topic_t topic, eos_u32_t time_ms)
+{
+    eos_event_pub_time(topic, time_ms, EOS_True);
+}
+
+void eos_event_pub_period(eos_topic_t topic, eos_u32_t time_ms_period)
+{
+    eos_event_pub_time(topic, time_ms_period, EOS_False);
+}
+
+void eos_event_time_cancel(eos_topic_t topic)
+{
+    EOS_WORKER_LOCK();
+#if (EOS_USE_TIMER_MIN_HEAP != 0)
+    eos_u16_t index = eos_timer_find(topic);
+    if (index != EOS_TIMER_NULL) {
+        eos_timer_remove(index);
+        eos.timeout_min = (eos.timer_count == 0) ?
+                            EOS_U32_MAX :
+                            eos.etimer[eos.timer_heap[0]].timeout_ms;
+    }
+#else
+    eos_u32_t timeout_min = EOS_U32_MAX;
+    for (eos_u32_t i = 0; i < eos.timer_count; i ++) {
+        if (topic != eos.etimer[i].topic) {
             timeout_min =   timeout_min > eos.etimer[i].timeout_ms ?
                             eos.etimer[i].timeout_ms :
                             timeout_min;
@@ -740,6 +1861,8 @@ void eos_event_time_cancel(eos_topic_t topic)
     }
 
     eos.timeout_min = timeout_min;
+#endif
+    EOS_WORKER_UNLOCK();
 }
 #endif
 
@@ -759,6 +1882,50 @@ eos_ret_t eos_super(eos_sm_t * const me, eos_state_handler state)
     return EOS_Ret_Super;
 }
 
+#if (EOS_USE_HSM_HISTORY != 0)
+static eos_sm_history_t *eos_sm_history_find(eos_sm_t * const me, eos_state_handler state)
+{
+    for (eos_u8_t i = 0; i < me->history_count; i ++) {
+        if (me->history[i].state == state) {
+            return &me->history[i];
+        }
+    }
+
+    return EOS_NULL;
+}
+
+void eos_sm_history(eos_sm_t * const me, eos_state_handler state)
+{
+    if (eos_sm_history_find(me, state) != EOS_NULL) {
+        return;
+    }
+
+    EOS_ASSERT(me->history_count < EOS_MAX_HSM_HISTORY);
+    eos_sm_history_t *history = &me->history[me->history_count ++];
+    history->state = state;
+    history->shallow = EOS_NULL;
+    history->deep = EOS_NULL;
+}
+
+eos_ret_t eos_tran_history(eos_sm_t * const me, eos_state_handler state)
+{
+    eos_sm_history_t *history = eos_sm_history_find(me, state);
+    EOS_ASSERT(history != EOS_NULL);
+    me->state = (history->shallow == EOS_NULL) ? state : history->shallow;
+
+    return EOS_Ret_Tran;
+}
+
+eos_ret_t eos_tran_deep_history(eos_sm_t * const me, eos_state_handler state)
+{
+    eos_sm_history_t *history = eos_sm_history_find(me, state);
+    EOS_ASSERT(history != EOS_NULL);
+    me->state = (history->deep == EOS_NULL) ? state : history->deep;
+
+    return EOS_Ret_Tran;
+}
+#endif
+
 eos_ret_t eos_state_top(eos_sm_t * const me, eos_event_t const * const e)
 {
     (void)me;
@@ -772,8 +1939,9 @@ eos_ret_t eos_state_top(eos_sm_t * const me, eos_event_t const * const e)
 #if (EOS_USE_SM_MODE != 0)
 static void eos_sm_dispath(eos_sm_t * const me, eos_event_t const * const e)
 {
-#if (EOS_USE_HSM_MODE != 0)
-    eos_state_handler path[EOS_MAX_HSM_NEST_DEPTH];
+#if (EOS_USE_HSM_MODE != 0 && EOS_USE_HSM_CACHE == 0)
+    // 目标状态向上的路径一直记录到eos_state_top，比最大嵌套层数多一个
+    eos_state_handler path[EOS_MAX_HSM_NEST_DEPTH + 1];
 #endif
     eos_ret_t r;
 
@@ -795,6 +1963,38 @@ static void eos_sm_dispath(eos_sm_t * const me, eos_event_t const * const e)
     else {
         me->state = s;
     }
+#elif (EOS_USE_HSM_CACHE != 0)
+    eos_state_handler t = me->state;
+    eos_state_handler s;
+
+    do {
+        s = me->state;
+        r = (*s)(me, e);
+    } while (r == EOS_Ret_Super);
+
+    if (r != EOS_Ret_Tran) {
+        me->state = t;
+        return;
+    }
+
+    // 由缓存的拓扑得到源状态与目标状态的最近公共祖先。先由当前状态向上退出到最近公共祖先
+    // （不含），再由其下进入到目标状态，最后钻入各层初始状态。
+#if (EOS_USE_HSM_TRAN_CACHE != 0)
+    eos_sm_tran_t *tran = eos_sm_tran_get(me, s, me->state);
+    if (tran != EOS_NULL) {
+        eos_hsm_exit(me, eos_hsm_node(me, t), tran->lca);
+        for (eos_u8_t i = 0; i < tran->enter_num; i ++) {
+            (void)HSM_TRIG_(tran->enter[i], Event_Enter);
+        }
+        eos_hsm_drill(me, tran->target);
+        return;
+    }
+#endif
+    eos_hsm_node_t *target = eos_hsm_node(me, me->state);
+    eos_hsm_node_t *lca = eos_hsm_lca(me, eos_hsm_node(me, s), target);
+    eos_hsm_exit(me, eos_hsm_node(me, t), lca->state);
+    eos_hsm_enter(me, lca, target);
+    eos_hsm_drill(me, target->state);
 #else
     eos_state_handler t = me->state;
     eos_state_handler s;
@@ -844,14 +2044,13 @@ static void eos_sm_dispath(eos_sm_t * const me, eos_event_t const * const e)
         (void)HSM_TRIG_(me->state, Event_Null);       // 获取其父状态
         while (me->state != t) {
             ip ++;
+            // 层数不能大于MAX_NEST_DEPTH_
+            EOS_ASSERT(ip < EOS_MAX_HSM_NEST_DEPTH);
             path[ip] = me->state;
             (void)HSM_TRIG_(me->state, Event_Null);   // 获取其父状态
         }
         me->state = path[0];
 
-        // 层数不能大于MAX_NEST_DEPTH_
-        EOS_ASSERT(ip < EOS_MAX_HSM_NEST_DEPTH);
-
         // retrace the entry path in reverse (correct) order...
         do {
             HSM_TRIG_(path[ip--], Event_Enter);       // 进入path[ip]
@@ -864,8 +2063,8 @@ static void eos_sm_dispath(eos_sm_t * const me, eos_event_t const * const e)
 #endif
 }
 
-#if (EOS_USE_HSM_MODE != 0)
-static eos_s32_t eos_sm_tran(eos_sm_t * const me, eos_state_handler path[EOS_MAX_HSM_NEST_DEPTH])
+#if (EOS_USE_HSM_MODE != 0 && EOS_USE_HSM_CACHE == 0)
+static eos_s32_t eos_sm_tran(eos_sm_t * const me, eos_state_handler path[EOS_MAX_HSM_NEST_DEPTH + 1])
 {
     // transition entry path index
     eos_s32_t ip = -1;
@@ -916,13 +2115,13 @@ static eos_s32_t eos_sm_tran(eos_sm_t * const me, eos_state_handler path[EOS_MAX
     r = HSM_TRIG_(path[1], Event_Null);
     while (r == EOS_Ret_Super) {
         ++ ip;
+        // entry path must not overflow
+        EOS_ASSERT(ip <= EOS_MAX_HSM_NEST_DEPTH);
         path[ip] = me->state; // store the entry path
         if (me->state == s) { // is it the source?
             // indicate that the LCA was found
             iq = 1;
 
-            // entry path must not overflow
-            EOS_ASSERT(ip < EOS_MAX_HSM_NEST_DEPTH);
             --ip;  // do not enter the source
             r = EOS_Ret_Handled; // terminate the loop
         }
@@ -934,7 +2133,7 @@ static eos_s32_t eos_sm_tran(eos_sm_t * const me, eos_state_handler path[EOS_MAX
     // LCA found yet?
     if (iq == 0) {
         // entry path must not overflow
-        EOS_ASSERT(ip < EOS_MAX_HSM_NEST_DEPTH);
+        EOS_ASSERT(ip <= EOS_MAX_HSM_NEST_DEPTH);
 
         HSM_TRIG_(s, Event_Exit); // exit the source
 
@@ -988,117 +2187,467 @@ static eos_s32_t eos_sm_tran(eos_sm_t * const me, eos_state_handler path[EOS_MAX
 #endif
 #endif
 
-/* heap library ------------------------------------------------------------- */
-void eos_heap_init(eos_heap_t * const me)
-{
-    eos_block_t * block_1st;
-    
-#if (EOS_USE_MAGIC != 0)
-    me->magic = EOS_MAGIC_NUMBER;
+/* hsm cache library -------------------------------------------------------- */
+#if (EOS_USE_HSM_CACHE != 0)
+// 状态的父状态与层数只取决于状态函数本身，第一次遇到时调用状态函数探测，之后的转换只查
+// 缓存。以状态函数的地址做开放寻址的哈希表，只加入不删除，因此查找无需加锁；加入时在临界
+// 区内先写好父状态与层数，最后发布状态函数。
+#define EOS_HSM_INDEX(index_)           ((index_) & (EOS_MAX_HSM_STATES - 1))
+#if (EOS_USE_ATOMIC != 0)
+#define EOS_HSM_LOAD(p_)                __atomic_load_n((p_), __ATOMIC_ACQUIRE)
+#define EOS_HSM_STORE(p_, v_)           __atomic_store_n((p_), (v_), __ATOMIC_RELEASE)
+#else
+#define EOS_HSM_LOAD(p_)                (*(p_))
+#define EOS_HSM_STORE(p_, v_)           (*(p_) = (v_))
 #endif
-    
-    // block start
-    me->queue = EOS_HEAP_MAX;
-    me->error_id = 0;
-    me->size = EOS_SIZE_HEAP;
-    me->empty = 1;
-    me->sub_general = 0;
-    me->current = EOS_HEAP_MAX;
 
-    memset(me->data, 0, EOS_SIZE_HEAP);
+static eos_u16_t eos_hsm_hash(eos_state_handler state)
+{
+    // 函数地址的低位多为0，乘以黄金分割常数后取高位
+    eos_u32_t key = (eos_u32_t)(eos_pointer_t)state * 2654435761u;
 
-    // the 1st free block
-    block_1st = (eos_block_t *)(me->data);
-   
-    block_1st->last = EOS_HEAP_MAX;
-    block_1st->size = EOS_SIZE_HEAP - (eos_u16_t)sizeof(eos_block_t);
-    block_1st->free = 1;
-    block_1st->next = EOS_HEAP_MAX;
+    return EOS_HSM_INDEX((eos_u16_t)(key >> 16));
 }
 
-void * eos_heap_malloc(eos_heap_t * const me, eos_u32_t size)
+static eos_hsm_node_t *eos_hsm_find(eos_state_handler state)
 {
-    eos_block_t * block;
-    eos_s16_t remaining;
+    eos_u16_t index = eos_hsm_hash(state);
+    eos_state_handler key;
 
-    if (size == 0) {
-        me->error_id = 1;
-        return EOS_NULL;
+    while ((key = EOS_HSM_LOAD(&eos.hsm_node[index].state)) != state) {
+        if (key == EOS_NULL) {
+            return EOS_NULL;
+        }
+        index = EOS_HSM_INDEX(index + 1);
     }
 
-    /* Find the first free block in the block-list. */
-    eos_u16_t next = 0;
-    do {
-        block = (eos_block_t *)(me->data + next);
-        remaining = (block->size - size - sizeof(eos_block_t));
-        if (block->free == 1 && remaining >= 0) {
-            break;
-        }
-        next = block->next;
-    } while (next != EOS_HEAP_MAX);
+    return &eos.hsm_node[index];
+}
 
-    if (next == EOS_HEAP_MAX) {
-        me->error_id = 2;
-        return EOS_NULL;
+static void eos_hsm_insert(eos_state_handler state, eos_state_handler parent, eos_u8_t depth)
+{
+    eos_port_critical_enter();
+    eos_u16_t index = eos_hsm_hash(state);
+    while (eos.hsm_node[index].state != EOS_NULL && eos.hsm_node[index].state != state) {
+        index = EOS_HSM_INDEX(index + 1);
     }
+    // 其他worker可能已经加入了这个状态
+    if (eos.hsm_node[index].state == EOS_NULL) {
+        // 至少留一个空位，查找总能结束
+        EOS_ASSERT(eos.hsm_count < (EOS_MAX_HSM_STATES - 1));
+        eos.hsm_node[index].parent = parent;
+        eos.hsm_node[index].up = EOS_NULL;
+        eos.hsm_node[index].depth = depth;
+        EOS_HSM_STORE(&eos.hsm_node[index].state, state);
+        eos.hsm_count ++;
+    }
+    eos_port_critical_exit();
+}
 
-    /* Divide the block into two blocks. */
-    /* ARM Cortex-M0不支持非对齐访问 */
-    eos_u8_t offset = (size % 4);
-    size = (offset == 0) ? size : (size + 4 - offset);
-    eos_pointer_t address = (eos_pointer_t)block + size + sizeof(eos_block_t);
-    eos_block_t * new_block = (eos_block_t *)address;
-    eos_u32_t _size = block->size - size - sizeof(eos_block_t);
+static void eos_hsm_cache_init(void)
+{
+    for (eos_u16_t i = 0; i < EOS_MAX_HSM_STATES; i ++) {
+        eos.hsm_node[i].state = EOS_NULL;
+    }
+    eos.hsm_count = 0;
+    eos_hsm_insert(eos_state_top, EOS_NULL, 0);
+}
 
-    /* Update the list. */
-    new_block->size = _size;
-    new_block->free = EOS_True;
-    new_block->next = block->next;
-    new_block->last = (eos_u16_t)((eos_pointer_t)block - (eos_pointer_t)me->data);
+// 查找状态的节点。未缓存时，先向上探测到已缓存的祖先得到层数，再由下至上逐层加入。
+static eos_hsm_node_t *eos_hsm_node(eos_sm_t * const me, eos_state_handler state)
+{
+    eos_hsm_node_t *node = eos_hsm_find(state);
+    if (node != EOS_NULL) {
+        return node;
+    }
 
-    block->next = (eos_u16_t)((eos_pointer_t)new_block - (eos_pointer_t)me->data);
-    block->size = size;
-    block->free = EOS_False;
-    block->offset = (offset == 0) ? 0 : (4 - offset);
+    eos_state_handler state_save = me->state;
+    eos_state_handler s = state;
+    eos_u8_t depth = 0;
+    do {
+        eos_ret_t ret = HSM_TRIG_(s, Event_Null);
+        EOS_ASSERT(ret == EOS_Ret_Super);
+        (void)ret;
+        s = me->state;
+        depth ++;
+        node = eos_hsm_find(s);
+    } while (node == EOS_NULL);
+    depth += node->depth;
+    EOS_ASSERT(depth <= EOS_MAX_HSM_NEST_DEPTH);
 
-    if (new_block->next != EOS_HEAP_MAX) {
-        eos_block_t * block_next2 = (eos_block_t *)((eos_pointer_t)me->data + new_block->next);
-        block_next2->last = (eos_u16_t)((eos_pointer_t)new_block - (eos_pointer_t)me->data);
+    s = state;
+    do {
+        (void)HSM_TRIG_(s, Event_Null);
+        eos_hsm_insert(s, me->state, depth);
+        s = me->state;
+        depth --;
+    } while (eos_hsm_find(s) == EOS_NULL);
+    me->state = state_save;
+
+    return eos_hsm_find(state);
+}
+
+// 父状态的节点，第一次使用时查找并记下。各个worker记下的值相同，无需加锁。
+static eos_hsm_node_t *eos_hsm_up(eos_sm_t * const me, eos_hsm_node_t *node)
+{
+    eos_hsm_node_t *up = EOS_HSM_LOAD(&node->up);
+    if (up == EOS_NULL) {
+        up = eos_hsm_node(me, node->parent);
+        EOS_HSM_STORE(&node->up, up);
+    }
+
+    return up;
+}
+
+// 转换的最近公共祖先，按层数对齐后同步向上得到。自身转换时为其父状态，源状态被退出。
+static eos_hsm_node_t *eos_hsm_lca(eos_sm_t * const me,
+                                   eos_hsm_node_t *source, eos_hsm_node_t *target)
+{
+    if (source == target) {
+        return eos_hsm_up(me, source);
+    }
+
+    while (source->depth > target->depth) {
+        source = eos_hsm_up(me, source);
+    }
+    while (target->depth > source->depth) {
+        target = eos_hsm_up(me, target);
+    }
+    while (source != target) {
+        source = eos_hsm_up(me, source);
+        target = eos_hsm_up(me, target);
+    }
+
+    return source;
+}
+
+// 由from向上逐层退出，直到祖先to（不退出to）。打开历史状态时，每退出一层，若其父状态
+// 记录历史，则记下该层为浅历史，from为深历史。
+static void eos_hsm_exit(eos_sm_t * const me, eos_hsm_node_t *from, eos_state_handler to)
+{
+#if (EOS_USE_HSM_HISTORY != 0)
+    eos_state_handler leaf = from->state;
+#endif
+
+    while (from->state != to) {
+        EOS_ASSERT(from->depth > 0);
+        (void)HSM_TRIG_(from->state, Event_Exit);
+#if (EOS_USE_HSM_HISTORY != 0)
+        eos_sm_history_t *history = eos_sm_history_find(me, from->parent);
+        if (history != EOS_NULL) {
+            history->shallow = from->state;
+            history->deep = leaf;
+        }
+#endif
+        from = eos_hsm_up(me, from);
+    }
+}
+
+// 由祖先from之下到to的各层状态，由上至下存入path，返回层数
+static eos_u8_t eos_hsm_path(eos_sm_t * const me,
+                             eos_hsm_node_t *from, eos_hsm_node_t *to, eos_state_handler *path)
+{
+    EOS_ASSERT(to->depth >= from->depth);
+    eos_u8_t num = to->depth - from->depth;
+
+    for (eos_u8_t i = num; i > 0; i --) {
+        path[i - 1] = to->state;
+        to = eos_hsm_up(me, to);
+    }
+    EOS_ASSERT(to == from);
+
+    return num;
+}
+
+// 由祖先from之下逐层进入，直到to。每一层都由to沿缓存的父状态向上找到，栈的占用与层数
+// 无关；层数为n时共向上n * (n - 1) / 2步，不调用状态函数。
+static void eos_hsm_enter(eos_sm_t * const me, eos_hsm_node_t *from, eos_hsm_node_t *to)
+{
+    EOS_ASSERT(to->depth >= from->depth);
+
+    for (eos_u16_t depth = from->depth + 1; depth <= to->depth; depth ++) {
+        eos_hsm_node_t *node = to;
+        while (node->depth > depth) {
+            node = eos_hsm_up(me, node);
+        }
+        // from必须是to的祖先
+        EOS_ASSERT(depth > from->depth + 1 || eos_hsm_up(me, node) == from);
+        (void)HSM_TRIG_(node->state, Event_Enter);
+    }
+}
+
+#if (EOS_USE_HSM_TRAN_CACHE != 0)
+// 转换的路径，先查该状态机的转换缓存，未命中时由状态拓扑计算，缓存满时依次替换。进入
+// 多于EOS_SIZE_HSM_TRAN_PATH层的转换不缓存，返回EOS_NULL，由调用者逐层进入。每个状态机
+// 同时只在一个worker中分发，无需加锁。
+static eos_sm_tran_t *eos_sm_tran_get(eos_sm_t * const me,
+                                      eos_state_handler source, eos_state_handler target)
+{
+    eos_sm_tran_t *tran;
+
+    for (eos_u8_t i = 0; i < me->tran_count; i ++) {
+        tran = &me->tran[i];
+        if (tran->source == source && tran->target == target) {
+            return tran;
+        }
+    }
+
+    eos_hsm_node_t *node_target = eos_hsm_node(me, target);
+    eos_hsm_node_t *lca = eos_hsm_lca(me, eos_hsm_node(me, source), node_target);
+    if (node_target->depth - lca->depth > EOS_SIZE_HSM_TRAN_PATH) {
+        return EOS_NULL;
+    }
+
+    if (me->tran_count < EOS_SIZE_HSM_TRAN_CACHE) {
+        tran = &me->tran[me->tran_count ++];
+    }
+    else {
+        tran = &me->tran[me->tran_next];
+        me->tran_next = (me->tran_next + 1) % EOS_SIZE_HSM_TRAN_CACHE;
+    }
+    tran->source = source;
+    tran->target = target;
+    tran->lca = lca->state;
+    tran->enter_num = eos_hsm_path(me, lca, node_target, tran->enter);
+
+    return tran;
+}
+#endif
+
+// 一级一级的钻入各层，直到初始化不再转换
+static void eos_hsm_drill(eos_sm_t * const me, eos_state_handler state)
+{
+    while (HSM_TRIG_(state, Event_Init) == EOS_Ret_Tran) {
+#if (EOS_USE_HSM_TRAN_CACHE != 0)
+        // 初始转换的目标必须是子孙状态，其路径与由该状态转换过去的相同
+        eos_sm_tran_t *tran = eos_sm_tran_get(me, state, me->state);
+        if (tran != EOS_NULL) {
+            EOS_ASSERT(tran->lca == state);
+            for (eos_u8_t i = 0; i < tran->enter_num; i ++) {
+                (void)HSM_TRIG_(tran->enter[i], Event_Enter);
+            }
+            state = tran->target;
+            continue;
+        }
+#endif
+        eos_hsm_node_t *target = eos_hsm_node(me, me->state);
+        eos_hsm_enter(me, eos_hsm_node(me, state), target);
+        state = target->state;
+    }
+    me->state = state;
+}
+#endif
+
+/* heap library ------------------------------------------------------------- */
+void eos_heap_init(eos_heap_t * const me)
+{
+    eos_block_t * block_1st;
+    
+#if (EOS_USE_MAGIC != 0)
+    me->magic = EOS_MAGIC_NUMBER;
+#endif
+    
+    // block start
+    me->queue = EOS_HEAP_MAX;
+    me->tail = EOS_HEAP_MAX;
+    me->error_id = 0;
+    me->size = EOS_SIZE_HEAP;
+    me->empty = 1;
+    me->current = EOS_HEAP_MAX;
+    me->count = 0;
+    for (eos_u8_t i = 0; i < EOS_MAX_ACTORS; i ++) {
+        me->cursor[i] = EOS_HEAP_MAX;
+    }
+#if (EOS_USE_HEAP_BIN != 0)
+    me->bin_en = 0;
+    for (eos_u8_t i = 0; i < EOS_HEAP_BIN_NUM; i ++) {
+        me->bin[i] = EOS_HEAP_MAX;
+    }
+#endif
+
+    memset(me->data, 0, EOS_SIZE_HEAP);
+
+    // the 1st free block
+    block_1st = (eos_block_t *)(me->data);
+   
+    block_1st->last = EOS_HEAP_MAX;
+    block_1st->size = EOS_SIZE_HEAP - (eos_u16_t)sizeof(eos_block_t);
+    block_1st->free = 1;
+    block_1st->next = EOS_HEAP_MAX;
+}
+
+#if (EOS_USE_HEAP_BIN != 0)
+/* 各级小块内存的大小，分别对应0, 4, 8, 16, 32, 64字节的事件数据，4字节对齐 */
+#define EOS_HEAP_BIN_SIZE(size_)                                               \
+    ((sizeof(eos_event_inner_t) + (size_) + 3) & ~3)
+
+static const eos_u16_t heap_bin_size[EOS_HEAP_BIN_NUM] = {
+    EOS_HEAP_BIN_SIZE(0), EOS_HEAP_BIN_SIZE(4), EOS_HEAP_BIN_SIZE(8),
+    EOS_HEAP_BIN_SIZE(16), EOS_HEAP_BIN_SIZE(32), EOS_HEAP_BIN_SIZE(64),
+};
+
+static eos_u8_t eos_heap_bin_index(eos_u32_t size)
+{
+    for (eos_u8_t i = 0; i < EOS_HEAP_BIN_NUM; i ++) {
+        if (size <= heap_bin_size[i]) {
+            return i;
+        }
+    }
+
+    return EOS_HEAP_BIN_NUM;
+}
+
+void eos_heap_init_bin(eos_heap_t * const me)
+{
+    eos_heap_init(me);
+    me->bin_en = 1;
+}
+
+void eos_heap_bin_flush(eos_heap_t * const me)
+{
+    for (eos_u8_t i = 0; i < EOS_HEAP_BIN_NUM; i ++) {
+        while (me->bin[i] != EOS_HEAP_MAX) {
+            eos_block_t * block = (eos_block_t *)(me->data + me->bin[i]);
+            me->bin[i] = block->q_next;
+            eos_heap_release(me, block);
+        }
     }
+}
+#endif
 
-    /* 挂在Queue的最后端 */
-    next = me->queue;
-    eos_block_t * block_queue;
+// 将预留的内存块挂在Queue的最后端，此后才能被Actor取走。
+void eos_heap_commit(eos_heap_t * const me, void * data)
+{
+    eos_block_t * block = (eos_block_t *)((eos_pointer_t)data - sizeof(eos_block_t));
+    EOS_ASSERT(block->free == 0);
+
+    eos_u16_t index = (eos_u16_t)((eos_pointer_t)block - (eos_pointer_t)me->data);
     if (me->queue == EOS_HEAP_MAX) {
-        me->queue = (eos_u16_t)((eos_pointer_t)block - (eos_pointer_t)me->data);
+        me->queue = index;
         block->q_next = EOS_HEAP_MAX;
         block->q_last = EOS_HEAP_MAX;
         me->current = me->queue;
     }
     else {
-        do {
-            block_queue = (eos_block_t *)(me->data + next);
-            next = block_queue->q_next;
-        } while (next != EOS_HEAP_MAX);
-
-        block_queue->q_next = (eos_u16_t)((eos_pointer_t)block - (eos_pointer_t)me->data);
+        eos_block_t * block_queue = (eos_block_t *)(me->data + me->tail);
+        block_queue->q_next = index;
         block->q_next = EOS_HEAP_MAX;
-        block->q_last = (eos_u16_t)((eos_pointer_t)block_queue - (eos_pointer_t)me->data);
+        block->q_last = me->tail;
     }
+    me->tail = index;
 
-    me->error_id = 0;
     me->empty = 0;
-    void *p = (void *)((eos_pointer_t)block + (eos_u32_t)sizeof(eos_block_t));
+}
+
+void * eos_heap_malloc(eos_heap_t * const me, eos_u32_t size)
+{
+    void *data = eos_heap_reserve(me, size);
+    if (data != EOS_NULL) {
+#if (EOS_USE_EVENT_REF != 0)
+        ((eos_event_inner_t *)data)->ref = 0;
+#endif
+        eos_heap_commit(me, data);
+    }
+
+    return data;
+}
+
+// 申请内存块，但不挂入Queue，由eos_heap_commit挂入。
+void * eos_heap_reserve(eos_heap_t * const me, eos_u32_t size)
+{
+    eos_block_t * block;
+    eos_s16_t remaining;
+    eos_u32_t size_req = size;
+
+    if (size == 0) {
+        me->error_id = 1;
+        return EOS_NULL;
+    }
+
+#if (EOS_USE_HEAP_BIN != 0)
+    /* 小块内存，优先从对应的空闲链表中直接取出 */
+    eos_u8_t bin = (me->bin_en != 0) ? eos_heap_bin_index(size) : EOS_HEAP_BIN_NUM;
+    if (bin < EOS_HEAP_BIN_NUM) {
+        if (me->bin[bin] != EOS_HEAP_MAX) {
+            block = (eos_block_t *)(me->data + me->bin[bin]);
+            me->bin[bin] = block->q_next;
+            block->offset = block->size - size_req;
+            me->error_id = 0;
+            me->count ++;
+
+            return (void *)((eos_pointer_t)block + sizeof(eos_block_t));
+        }
+        size = heap_bin_size[bin];
+    }
+#endif
+
+    /* Find the first free block in the block-list. */
+    eos_u16_t next = 0;
+    do {
+        block = (eos_block_t *)(me->data + next);
+        remaining = (block->size - size - sizeof(eos_block_t));
+        if (block->free == 1 && remaining >= 0) {
+            break;
+        }
+        next = block->next;
+    } while (next != EOS_HEAP_MAX);
+
+    if (next == EOS_HEAP_MAX) {
+#if (EOS_USE_HEAP_BIN != 0)
+        /* 将空闲链表中的内存归还后，再尝试一次 */
+        eos_bool_t bin_empty = EOS_True;
+        for (eos_u8_t i = 0; i < EOS_HEAP_BIN_NUM; i ++) {
+            if (me->bin[i] != EOS_HEAP_MAX) {
+                bin_empty = EOS_False;
+            }
+        }
+        if (bin_empty == EOS_False) {
+            eos_heap_bin_flush(me);
+            return eos_heap_reserve(me, size_req);
+        }
+#endif
+        me->error_id = 2;
+        return EOS_NULL;
+    }
+
+    /* Divide the block into two blocks. */
+    /* ARM Cortex-M0不支持非对齐访问 */
+    eos_u8_t offset = (size % 4);
+    size = (offset == 0) ? size : (size + 4 - offset);
+    eos_pointer_t address = (eos_pointer_t)block + size + sizeof(eos_block_t);
+    eos_block_t * new_block = (eos_block_t *)address;
+    eos_u32_t _size = block->size - size - sizeof(eos_block_t);
+
+    /* Update the list. */
+    new_block->size = _size;
+    new_block->free = EOS_True;
+    new_block->next = block->next;
+    new_block->last = (eos_u16_t)((eos_pointer_t)block - (eos_pointer_t)me->data);
+
+    block->next = (eos_u16_t)((eos_pointer_t)new_block - (eos_pointer_t)me->data);
+    block->size = size;
+    block->free = EOS_False;
+    block->offset = size - size_req;
+
+    if (new_block->next != EOS_HEAP_MAX) {
+        eos_block_t * block_next2 = (eos_block_t *)((eos_pointer_t)me->data + new_block->next);
+        block_next2->last = (eos_u16_t)((eos_pointer_t)new_block - (eos_pointer_t)me->data);
+    }
+    me->error_id = 0;
     me->count ++;
 
-    return p;
+    return (void *)((eos_pointer_t)block + sizeof(eos_block_t));
 }
 
 void eos_heap_gc(eos_heap_t * const me, void *data)
 {
     eos_event_inner_t *e = (eos_event_inner_t *)data;
 
+#if (EOS_USE_EVENT_REF != 0)
+    if (e->sub == 0 && e->ref == 0) {
+#else
     if (e->sub == 0) {
+#endif
         eos_block_t *block = (eos_block_t *)((eos_pointer_t)data - sizeof(eos_block_t));
         eos_u16_t index = (eos_u16_t)((eos_pointer_t)block - (eos_pointer_t)me->data);
         eos_block_t *block_last = (eos_block_t *)(me->data + block->q_last);
@@ -1110,6 +2659,7 @@ void eos_heap_gc(eos_heap_t * const me, void *data)
             me->empty = 1;
             me->current = EOS_HEAP_MAX;
             me->queue = EOS_HEAP_MAX;
+            me->tail = EOS_HEAP_MAX;
         }
         // 如果这个block在Queue的第一个
         else if (me->queue == index) {
@@ -1120,6 +2670,7 @@ void eos_heap_gc(eos_heap_t * const me, void *data)
         // 如果这个block在Queue的最后一个
         else if (block->q_next == EOS_HEAP_MAX) {
             block_last->q_next = EOS_HEAP_MAX;
+            me->tail = block->q_last;
             me->current = me->queue;
         }
         else {
@@ -1128,47 +2679,54 @@ void eos_heap_gc(eos_heap_t * const me, void *data)
             me->current = block->q_next;
         }
 
+        /* 指向此block的游标，回退到其前一个block */
+        for (eos_u8_t i = 0; i < EOS_MAX_ACTORS; i ++) {
+            if (me->cursor[i] == index) {
+                me->cursor[i] = block->q_last;
+            }
+        }
+
         /* 释放这块内存 */
         eos_heap_free(me, data);
     }
+}
 
-    /* 根据所有的sub重新生成sub_general */
-    me->sub_general = 0;
-    eos_u16_t next = me->queue;
-    eos_u16_t loop_count = 0;
-    eos_block_t *block;
-    while (next != EOS_HEAP_MAX && loop_count < me->count) {
-        eos_event_inner_t *evt;
-        block = (eos_block_t *)((eos_pointer_t)me->data + next);
-        evt = (eos_event_inner_t *)((eos_pointer_t)block + sizeof(eos_block_t));
-        me->sub_general |= evt->sub;
-        next = block->q_next;
-
-        loop_count ++;
+void *eos_heap_get_block(eos_heap_t * const me, eos_u8_t priority)
+{
+    eos_event_inner_t *e = eos_heap_find(me, priority);
+    if (e != EOS_NULL) {
+        e->sub &=~ EOS_SUB_BIT(priority);
     }
+
+    return (void *)e;
 }
 
-void *eos_heap_get_block(eos_heap_t * const me, eos_u8_t priority)
+static void *eos_heap_find(eos_heap_t * const me, eos_u8_t priority)
 {
     eos_block_t * block = EOS_NULL;
     eos_event_inner_t *e = EOS_NULL;
 
     EOS_ASSERT(priority < EOS_MAX_ACTORS);
 
-    eos_u16_t next = me->queue;
+    // 从该Actor的游标处开始查找，游标之前的事件均已被此Actor取走。
+    // 对每个Actor，每个block最多被扫描一次，均摊复杂度为O(1)。
+    eos_u16_t next = me->cursor[priority];
+    if (next == EOS_HEAP_MAX) {
+        next = me->queue;
+    }
     eos_u16_t loop_count = 0;
     while (next != EOS_HEAP_MAX && loop_count < me->count) {
         eos_event_inner_t *evt;
         block = (eos_block_t *)((eos_pointer_t)me->data + next);
         EOS_ASSERT(block->free == 0);
         evt = (eos_event_inner_t *)((eos_pointer_t)block + sizeof(eos_block_t));
-        if ((evt->sub & (1 << priority)) == 0) {
+        me->cursor[priority] = next;
+        if ((evt->sub & EOS_SUB_BIT(priority)) == 0) {
             next = block->q_next;
             loop_count ++;
         }
         else {
             e = evt;
-            evt->sub &=~ (1 << priority);
             break;
         }
     }
@@ -1179,8 +2737,27 @@ void *eos_heap_get_block(eos_heap_t * const me, eos_u8_t priority)
 void eos_heap_free(eos_heap_t * const me, void * data)
 {
     eos_block_t * block = (eos_block_t *)((eos_pointer_t)data - sizeof(eos_block_t));
-    eos_block_t * block_next;
     me->error_id = 0;
+    me->count --;
+
+#if (EOS_USE_HEAP_BIN != 0)
+    /* 小块内存不合并，直接挂入对应的空闲链表 */
+    if (me->bin_en != 0) {
+        eos_u8_t bin = eos_heap_bin_index(block->size);
+        if (bin < EOS_HEAP_BIN_NUM && block->size == heap_bin_size[bin]) {
+            block->q_next = me->bin[bin];
+            me->bin[bin] = (eos_u16_t)((eos_pointer_t)block - (eos_pointer_t)me->data);
+            return;
+        }
+    }
+#endif
+
+    eos_heap_release(me, block);
+}
+
+static void eos_heap_release(eos_heap_t * const me, eos_block_t * block)
+{
+    eos_block_t * block_next;
     if (block->last != EOS_HEAP_MAX) {
         eos_block_t * block_last = (eos_block_t *)(me->data + block->last);
         /* Check the block can be combined with the front one. */
@@ -1210,9 +2787,826 @@ void eos_heap_free(eos_heap_t * const me, void * data)
     }
 
     block->free = 1;
-    me->count --;
 }
 
+/* timer library ------------------------------------------------------------ */
+#if (EOS_USE_TIME_EVENT != 0 && EOS_USE_TIMER_MIN_HEAP != 0)
+// etimer保持紧凑，下标即定时器的编号；timer_heap为按超时时间排列的最小堆，
+// timer_pos记录各定时器在堆中的位置；timer_hash按主题索引，用于查重与取消。
+#define EOS_TIMER_HASH(topic_)          ((topic_) & (EOS_TIMER_HASH_SIZE - 1))
+#define EOS_TIMER_TIMEOUT(pos_)         (eos.etimer[eos.timer_heap[pos_]].timeout_ms)
+
+static void eos_timer_init(void)
+{
+    eos.timer_count = 0;
+    eos.timer_heap_size = 0;
+    eos.timeout_min = EOS_U32_MAX;
+    for (eos_u16_t i = 0; i < EOS_TIMER_HASH_SIZE; i ++) {
+        eos.timer_hash[i] = EOS_TIMER_NULL;
+    }
+}
+
+static void eos_timer_place(eos_u16_t pos, eos_u16_t index)
+{
+    eos.timer_heap[pos] = index;
+    eos.timer_pos[index] = pos;
+}
+
+static void eos_timer_sift_up(eos_u16_t pos)
+{
+    eos_u16_t index = eos.timer_heap[pos];
+    eos_u32_t timeout = eos.etimer[index].timeout_ms;
+    while (pos > 0) {
+        eos_u16_t parent = (pos - 1) >> 1;
+        if (EOS_TIMER_TIMEOUT(parent) <= timeout) {
+            break;
+        }
+        eos_timer_place(pos, eos.timer_heap[parent]);
+        pos = parent;
+    }
+    eos_timer_place(pos, index);
+}
+
+static void eos_timer_sift_down(eos_u16_t pos)
+{
+    eos_u16_t index = eos.timer_heap[pos];
+    eos_u32_t timeout = eos.etimer[index].timeout_ms;
+    while (1) {
+        eos_u32_t child = ((eos_u32_t)pos << 1) + 1;
+        if (child >= eos.timer_heap_size) {
+            break;
+        }
+        if ((child + 1) < eos.timer_heap_size &&
+            EOS_TIMER_TIMEOUT(child + 1) < EOS_TIMER_TIMEOUT(child)) {
+            child ++;
+        }
+        if (timeout <= EOS_TIMER_TIMEOUT(child)) {
+            break;
+        }
+        eos_timer_place(pos, eos.timer_heap[child]);
+        pos = (eos_u16_t)child;
+    }
+    eos_timer_place(pos, index);
+}
+
+static eos_u16_t eos_timer_find(eos_topic_t topic)
+{
+    eos_u16_t index = eos.timer_hash[EOS_TIMER_HASH(topic)];
+    while (index != EOS_TIMER_NULL && eos.etimer[index].topic != topic) {
+        index = eos.timer_next[index];
+    }
+
+    return index;
+}
+
+// 将已经填入etimer[timer_count]的定时器，加入哈希表与堆。
+static void eos_timer_add(void)
+{
+    EOS_ASSERT(eos.timer_heap_size == eos.timer_count);
+
+    eos_u16_t index = eos.timer_count ++;
+    eos_u16_t bucket = EOS_TIMER_HASH(eos.etimer[index].topic);
+    eos.timer_next[index] = eos.timer_hash[bucket];
+    eos.timer_hash[bucket] = index;
+
+    eos_timer_place(eos.timer_heap_size, index);
+    eos.timer_heap_size ++;
+    eos_timer_sift_up(eos.timer_heap_size - 1);
+}
+
+static void eos_timer_unlink(eos_u16_t index, eos_u16_t index_new)
+{
+    eos_u16_t *link = &eos.timer_hash[EOS_TIMER_HASH(eos.etimer[index].topic)];
+    while (*link != index) {
+        link = &eos.timer_next[*link];
+    }
+    *link = (index_new == EOS_TIMER_NULL) ? eos.timer_next[index] : index_new;
+}
+
+static void eos_timer_remove(eos_u16_t index)
+{
+    eos_u16_t pos = eos.timer_pos[index];
+    eos_u16_t last = eos.timer_count - 1;
+
+    // 从堆中删除，堆尾补位；堆之后暂存的定时器，由最后一个补到堆尾。
+    if (pos < eos.timer_heap_size) {
+        eos_u16_t tail = -- eos.timer_heap_size;
+        if (pos != tail) {
+            eos_timer_place(pos, eos.timer_heap[tail]);
+        }
+        if (tail != last) {
+            eos_timer_place(tail, eos.timer_heap[last]);
+        }
+        if (pos < eos.timer_heap_size) {
+            if (pos > 0 && EOS_TIMER_TIMEOUT(pos) < EOS_TIMER_TIMEOUT((pos - 1) >> 1)) {
+                eos_timer_sift_up(pos);
+            }
+            else {
+                eos_timer_sift_down(pos);
+            }
+        }
+    }
+    else if (pos != last) {
+        eos_timer_place(pos, eos.timer_heap[last]);
+    }
+
+    // 从哈希表中删除；并将最后一个定时器移入空位，与数组实现的删除方式一致。
+    eos_timer_unlink(index, EOS_TIMER_NULL);
+    if (index != last) {
+        eos_timer_unlink(last, index);
+        eos.etimer[index] = eos.etimer[last];
+        eos.timer_next[index] = eos.timer_next[last];
+        eos_timer_place(eos.timer_pos[last], index);
+    }
+    eos.timer_count = last;
+}
+#endif
+
+/* bitmap library ----------------------------------------------------------- */
+#if (EOS_USE_CLZ != 0)
+// 最高的置位，sub不能为0
+static eos_u8_t eos_sub_highest(eos_sub_t sub)
+{
+#if (EOS_MAX_ACTORS > 32)
+    eos_u32_t high = (eos_u32_t)(sub >> 32);
+    if (high != 0) {
+        return (eos_u8_t)(63 - __builtin_clz(high));
+    }
+#endif
+
+    return (eos_u8_t)(31 - __builtin_clz((eos_u32_t)sub));
+}
+#else
+static const eos_u8_t eos_nibble_highest[16] = {
+    0, 0, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3
+};
+
+static eos_u8_t eos_byte_highest(eos_u8_t byte)
+{
+    if ((byte & 0xf0) != 0) {
+        return (eos_u8_t)(4 + eos_nibble_highest[byte >> 4]);
+    }
+
+    return eos_nibble_highest[byte];
+}
+
+// 最高的置位，sub不能为0
+static eos_u8_t eos_sub_highest(eos_sub_t sub)
+{
+#if (EOS_MAX_ACTORS > 8)
+    // 先找最高的非零字节
+    eos_u8_t group = (sizeof(eos_sub_t) - 1);
+    while ((eos_u8_t)(sub >> (group << 3)) == 0) {
+        group --;
+    }
+
+    return (eos_u8_t)((group << 3) + eos_byte_highest((eos_u8_t)(sub >> (group << 3))));
+#else
+    return eos_byte_highest((eos_u8_t)sub);
+#endif
+}
+#endif
+
+#if (EOS_USE_PREEMPT != 0)
+// 不低于n的所有位，n超出位图宽度时为0
+static eos_sub_t eos_sub_above(eos_u8_t n)
+{
+    if (n >= (sizeof(eos_sub_t) << 3)) {
+        return 0;
+    }
+
+    return (eos_sub_t)~(EOS_SUB_BIT(n) - 1);
+}
+
+// sub中有优先级高于当前运行的Actor时，请求port抢占。需在临界区内调用。
+static void eos_preempt_check(eos_sub_t sub)
+{
+#if (EOS_USE_TIME_EVENT != 0)
+    sub &= ~eos.sub_delay;
+#endif
+    if (eos.prio_run != 0 &&
+        (sub & eos_sub_above(eos.prio_run)) != 0 &&
+        EOS_PREEMPT_ENABLED() != 0) {
+        eos_port_preempt();
+    }
+}
+#endif
+
+#if (EOS_USE_MULTI_WORKER == 0)
+// 优先级最高的就绪Actor，sub_general不能为0
+static eos_u8_t eos_ready_highest(void)
+{
+#if (EOS_USE_SUB_GROUP != 0)
+    // 通过第二级位图，直接找到最高的非零字节
+    eos_u8_t group = eos_byte_highest(eos.sub_group);
+    return (eos_u8_t)((group << 3) +
+                      eos_byte_highest((eos_u8_t)(eos.sub_general >> (group << 3))));
+#else
+    return eos_sub_highest(eos.sub_general);
+#endif
+}
+#endif
+
+/* ring library ------------------------------------------------------------- */
+// 记录以序号(serial)标识，序号对队列深度取模即为下标，因此队列深度必须为2的幂。
+#define EOS_RING_INDEX(serial_)         ((serial_) & (EOS_SIZE_TOPIC_QUEUE - 1))
+
+void eos_ring_init(eos_ring_t * const me)
+{
+    me->head = 0;
+    me->count = 0;
+    for (eos_u8_t i = 0; i < EOS_MAX_ACTORS; i ++) {
+        me->cursor[i] = 0;
+    }
+}
+
+eos_event_record_t * eos_ring_push(eos_ring_t * const me)
+{
+    if (me->count >= EOS_SIZE_TOPIC_QUEUE) {
+        return EOS_NULL;
+    }
+
+    eos_u16_t serial = me->head + me->count;
+    me->count ++;
+
+    return &me->record[EOS_RING_INDEX(serial)];
+}
+
+eos_event_record_t * eos_ring_find(eos_ring_t * const me, eos_u8_t priority)
+{
+    EOS_ASSERT(priority < EOS_MAX_ACTORS);
+
+    // 游标之前的记录均已被此Actor取走。释放记录时落后的游标已移到head，游标总在
+    // [head, tail]之间，序号回绕后也不会误判。
+    eos_u16_t serial = me->cursor[priority];
+    eos_u16_t tail = me->head + me->count;
+    EOS_ASSERT((eos_u16_t)(serial - me->head) <= me->count);
+    while (serial != tail) {
+        eos_event_record_t *r = &me->record[EOS_RING_INDEX(serial)];
+        if ((r->sub & EOS_SUB_BIT(priority)) != 0) {
+            me->cursor[priority] = serial;
+            return r;
+        }
+        serial ++;
+    }
+    me->cursor[priority] = tail;
+
+    return EOS_NULL;
+}
+
+void eos_ring_take(eos_ring_t * const me, eos_event_record_t * record, eos_u8_t priority)
+{
+    record->sub &=~ EOS_SUB_BIT(priority);
+    me->cursor[priority] ++;
+
+    // 所有订阅者都已取走的记录，从头部释放
+    eos_u16_t head = me->head;
+    while (me->count != 0 && me->record[EOS_RING_INDEX(me->head)].sub == 0) {
+        me->head ++;
+        me->count --;
+    }
+
+    // 长期空闲的Actor的游标停在释放的记录上，移到新的head，以免序号回绕后落回队列中
+    eos_u16_t released = me->head - head;
+    if (released != 0) {
+        for (eos_u8_t i = 0; i < EOS_MAX_ACTORS; i ++) {
+            if ((eos_u16_t)(me->cursor[i] - head) < released) {
+                me->cursor[i] = me->head;
+            }
+        }
+    }
+}
+
+/* ingress library ---------------------------------------------------------- */
+#if (EOS_USE_PUB_INGRESS != 0)
+// 有界的多生产者单消费者队列。每个槽位的状态记录其序号：空闲时等于序号，写满后等于
+// 序号加1，被取走后等于序号加队列深度（即下一轮的序号）。生产者以CAS占用tail，
+// 之后单独写入自己的槽位，因此生产者之间、生产者与消费者之间都无需加锁。
+#define EOS_INGRESS_INDEX(serial_)      ((serial_) & (EOS_SIZE_PUB_INGRESS - 1))
+
+#if (EOS_USE_ATOMIC != 0)
+#define EOS_LOAD_ACQUIRE(p_)            __atomic_load_n((p_), __ATOMIC_ACQUIRE)
+#define EOS_STORE_RELEASE(p_, v_)       __atomic_store_n((p_), (v_), __ATOMIC_RELEASE)
+#else
+#define EOS_LOAD_ACQUIRE(p_)            (*(volatile eos_u16_t *)(p_))
+#define EOS_STORE_RELEASE(p_, v_)       (*(volatile eos_u16_t *)(p_) = (v_))
+#endif
+
+void eos_ingress_init(eos_ingress_t * const me)
+{
+    for (eos_u16_t i = 0; i < EOS_SIZE_PUB_INGRESS; i ++) {
+        me->state[i] = i;
+    }
+    me->tail = 0;
+    me->head = 0;
+}
+
+eos_bool_t eos_ingress_push(eos_ingress_t * const me, eos_topic_t topic)
+{
+    eos_u16_t serial = EOS_LOAD_ACQUIRE(&me->tail);
+
+    while (1) {
+        eos_u16_t index = EOS_INGRESS_INDEX(serial);
+        eos_s16_t diff = (eos_s16_t)(EOS_LOAD_ACQUIRE(&me->state[index]) - serial);
+        // 槽位尚未被消费者取走，队列已满
+        if (diff < 0) {
+            return EOS_False;
+        }
+        // 其他生产者已经占用了此序号
+        if (diff > 0) {
+            serial = EOS_LOAD_ACQUIRE(&me->tail);
+            continue;
+        }
+
+        // 占用此序号，失败时serial被更新为最新的tail
+#if (EOS_USE_ATOMIC != 0)
+        if (__atomic_compare_exchange_n(&me->tail, &serial, (eos_u16_t)(serial + 1), 1,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) == 0) {
+            continue;
+        }
+#else
+        eos_port_critical_enter();
+        if (me->tail != serial) {
+            serial = me->tail;
+            eos_port_critical_exit();
+            continue;
+        }
+        me->tail = serial + 1;
+        eos_port_critical_exit();
+#endif
+        me->topic[index] = topic;
+        EOS_STORE_RELEASE(&me->state[index], (eos_u16_t)(serial + 1));
+
+        return EOS_True;
+    }
+}
+
+eos_bool_t eos_ingress_pop(eos_ingress_t * const me, eos_topic_t *topic)
+{
+    eos_u16_t index = EOS_INGRESS_INDEX(me->head);
+
+    // 槽位已被占用但尚未写完时，也视为空，等待下次取出
+    if (EOS_LOAD_ACQUIRE(&me->state[index]) != (eos_u16_t)(me->head + 1)) {
+        return EOS_False;
+    }
+    *topic = me->topic[index];
+    EOS_STORE_RELEASE(&me->state[index], (eos_u16_t)(me->head + EOS_SIZE_PUB_INGRESS));
+    me->head ++;
+
+    return EOS_True;
+}
+
+// 将入口环中的事件转入事件队列，在调度器中，以及直接发布事件之前调用。取出都在临界区
+// 内进行，入口环因此只有一个消费者；每个事件的取出与入队在同一临界区内完成，所以同一
+// 发布者之后直接发布的事件，总是排在其后。
+static void eos_ingress_drain(void)
+{
+    eos_topic_t topic;
+
+    while (1) {
+        eos_port_critical_enter();
+        eos_bool_t popped = eos_ingress_pop(&eos.ingress, &topic);
+        eos_s8_t ret = (eos_s8_t)EosRun_OK;
+        if (popped == EOS_True) {
+            ret = eos_event_queue_topic(topic);
+        }
+        eos_port_critical_exit();
+        EOS_ASSERT(ret >= 0);
+        (void)ret;
+        if (popped == EOS_False) {
+            break;
+        }
+#if (EOS_USE_EVENT_BRIDGE != 0)
+        (void)eos_bridge_forward(topic, EOS_NULL, 0);
+#endif
+    }
+}
+#endif
+
+/* bridge library ----------------------------------------------------------- */
+#if (EOS_USE_EVENT_BRIDGE != 0)
+// 环形缓冲区的两端可能在不同的进程或内核中，读写位置以原子操作访问。门铃前后的全屏障
+// 保证：发送方看到接收方已经取空，或者接收方在取空之后看到新的记录，二者至少有一个成立。
+#define EOS_BRIDGE_PAD                  (0xffff)
+#define EOS_BRIDGE_INDEX(serial_)       ((serial_) & (EOS_SIZE_BRIDGE - 1))
+#define EOS_BRIDGE_ALIGN(size_)         (((size_) + 3) & ~3)
+#if defined(__GNUC__)
+#define EOS_BRIDGE_LOAD(p_)             __atomic_load_n((p_), __ATOMIC_ACQUIRE)
+#define EOS_BRIDGE_STORE(p_, v_)        __atomic_store_n((p_), (v_), __ATOMIC_RELEASE)
+#define EOS_BRIDGE_FENCE()              __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#define EOS_BRIDGE_LOAD(p_)             (*(volatile eos_u32_t *)(p_))
+#define EOS_BRIDGE_STORE(p_, v_)        (*(volatile eos_u32_t *)(p_) = (v_))
+#define EOS_BRIDGE_FENCE()              ((void)0)
+#endif
+
+void eos_bridge_ring_init(eos_bridge_ring_t * const me)
+{
+    me->head = 0;
+    me->tail = 0;
+    me->doorbell = 0;
+    me->lost = 0;
+}
+
+// 只能有一个发送方。缓冲区已满时丢弃该事件，返回EOS_False。
+static eos_bool_t eos_bridge_write(eos_bridge_ring_t * const me,
+                                   eos_topic_t topic, void const *data, eos_u32_t size)
+{
+    eos_u32_t len = sizeof(eos_bridge_record_t) + EOS_BRIDGE_ALIGN(size);
+    eos_u32_t head = me->head;
+    eos_u32_t offset = EOS_BRIDGE_INDEX(head);
+    // 记录连续存放，尾部空间不足时，以填充记录跳到开头
+    eos_u32_t pad = (offset + len > EOS_SIZE_BRIDGE) ? (EOS_SIZE_BRIDGE - offset) : 0;
+    eos_u32_t tail = EOS_BRIDGE_LOAD(&me->tail);
+    if (size > 0xffff || pad + len > EOS_SIZE_BRIDGE - (head - tail)) {
+        me->lost ++;
+        return EOS_False;
+    }
+
+    eos_u8_t *buffer = (eos_u8_t *)me->data;
+    if (pad != 0) {
+        ((eos_bridge_record_t *)&buffer[offset])->topic = EOS_BRIDGE_PAD;
+        offset = 0;
+    }
+    eos_bridge_record_t *record = (eos_bridge_record_t *)&buffer[offset];
+    record->topic = topic;
+    record->size = (eos_u16_t)size;
+    eos_u8_t *record_data = (eos_u8_t *)record + sizeof(eos_bridge_record_t);
+    for (eos_u32_t i = 0; i < size; i ++) {
+        record_data[i] = ((eos_u8_t const *)data)[i];
+    }
+    EOS_BRIDGE_STORE(&me->head, head + pad + len);
+
+    // 接收方已取完之前的记录，可能正在等待，敲门铃。否则，接收方会连同之前的记录一并取走。
+    EOS_BRIDGE_FENCE();
+    if (EOS_BRIDGE_LOAD(&me->tail) == head) {
+        EOS_BRIDGE_STORE(&me->doorbell, me->doorbell + 1);
+        eos_port_bridge_notify(me);
+    }
+
+    return EOS_True;
+}
+
+// 只能有一个接收方。返回最老的记录，为空时返回EOS_NULL。
+eos_bridge_record_t * eos_bridge_peek(eos_bridge_ring_t * const me)
+{
+    eos_u32_t tail = me->tail;
+
+    while (tail != EOS_BRIDGE_LOAD(&me->head)) {
+        eos_u32_t offset = EOS_BRIDGE_INDEX(tail);
+        eos_bridge_record_t *record =
+            (eos_bridge_record_t *)((eos_u8_t *)me->data + offset);
+        if (record->topic != EOS_BRIDGE_PAD) {
+            return record;
+        }
+        tail += (EOS_SIZE_BRIDGE - offset);
+        EOS_BRIDGE_STORE(&me->tail, tail);
+        EOS_BRIDGE_FENCE();
+    }
+
+    return EOS_NULL;
+}
+
+void eos_bridge_take(eos_bridge_ring_t * const me, eos_bridge_record_t * const record)
+{
+    eos_u32_t len = sizeof(eos_bridge_record_t) + EOS_BRIDGE_ALIGN(record->size);
+
+    EOS_BRIDGE_STORE(&me->tail, me->tail + len);
+    EOS_BRIDGE_FENCE();
+}
+
+void eos_bridge_shm_init(eos_bridge_t * const shm)
+{
+    eos_bridge_ring_init(&shm->ring[0]);
+    eos_bridge_ring_init(&shm->ring[1]);
+}
+
+void eos_bridge_attach(eos_bridge_t * const shm, eos_u8_t side)
+{
+    EOS_ASSERT(side < 2);
+
+    eos_port_critical_enter();
+    eos.bridge_tx = &shm->ring[side];
+    eos.bridge_rx = &shm->ring[1 - side];
+    eos_port_critical_exit();
+}
+
+void eos_bridge_export(eos_topic_t topic)
+{
+    EOS_ASSERT(topic >= Event_User && topic < EOS_BRIDGE_PAD);
+
+    for (eos_u8_t i = 0; i < eos.bridge_count; i ++) {
+        if (eos.bridge_topic[i] == topic) {
+            return;
+        }
+    }
+    EOS_ASSERT(eos.bridge_count < EOS_MAX_BRIDGE_TOPIC);
+    eos.bridge_topic[eos.bridge_count ++] = topic;
+}
+
+// 转发的主题返回EOS_True，即使缓冲区已满而被丢弃
+static eos_bool_t eos_bridge_forward(eos_topic_t topic, void const *data, eos_u32_t size)
+{
+#if (EOS_USE_BRIDGE_STREAM != 0)
+    if (eos.bridge_tx == EOS_NULL && eos.stream.enabled == EOS_False) {
+        return EOS_False;
+    }
+#else
+    if (eos.bridge_tx == EOS_NULL) {
+        return EOS_False;
+    }
+#endif
+
+    for (eos_u8_t i = 0; i < eos.bridge_count; i ++) {
+        if (eos.bridge_topic[i] != topic) {
+            continue;
+        }
+        // 本实例中的多个发布者共用一个发送方
+        eos_port_critical_enter();
+        if (eos.bridge_tx != EOS_NULL) {
+            eos_bridge_write(eos.bridge_tx, topic, data, size);
+        }
+#if (EOS_USE_BRIDGE_STREAM != 0)
+        if (eos.stream.enabled != EOS_False) {
+            eos_stream_append(topic, data, size);
+        }
+#endif
+        eos_port_critical_exit();
+#if (EOS_USE_BRIDGE_STREAM != 0 && EOS_USE_IDLE_WAKEUP != 0)
+        // 只有对端订阅时，本地发布不会唤醒调度器，而帧由调度器发送
+        eos_port_wakeup();
+#endif
+
+        return EOS_True;
+    }
+
+    return EOS_False;
+}
+
+// 取出对端发来的全部事件，发布到本实例，只在调度器中调用
+static void eos_bridge_poll(void)
+{
+    eos_bridge_record_t *record;
+
+    if (eos.bridge_rx == EOS_NULL) {
+        return;
+    }
+    while ((record = eos_bridge_peek(eos.bridge_rx)) != EOS_NULL) {
+        eos_topic_t topic = record->topic;
+#if (EOS_USE_PUB_SUB != 0)
+        if (topic >= Event_User && topic < eos.topic_max)
+#else
+        if (topic >= Event_User)
+#endif
+        {
+            // 堆空间不足时，留在缓冲区中，下次调度时再取
+            eos_s8_t ret = eos_event_pub_local(topic,
+                                               (eos_u8_t *)record + sizeof(eos_bridge_record_t),
+                                               record->size);
+            if (ret == (eos_s8_t)EosRunErr_MallocFail) {
+                break;
+            }
+        }
+        eos_bridge_take(eos.bridge_rx, record);
+    }
+}
+
+#if (EOS_USE_BRIDGE_STREAM != 0)
+// 帧格式，COBS编码前：{主题(2), 长度(2), 数据}*N + CRC16(2)，多字节均为小端。
+// COBS编码后帧内没有0x00，以0x00作为帧尾，接收方从任意位置开始都能在下一帧重新同步。
+#define EOS_STREAM_HEADER               (4)
+// 长度为n的数据编码后的最大长度，另加CRC、帧尾与一个COBS码字节
+#define EOS_STREAM_WORST(n_)            ((n_) + (n_) / 254 + 1)
+#define EOS_STREAM_TRAILER              (EOS_STREAM_WORST(2) + 1)
+
+// CRC-16/CCITT-FALSE，半字节查表
+static const eos_u16_t eos_crc16_table[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+    0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
+};
+
+static eos_u16_t eos_crc16(eos_u16_t crc, eos_u8_t byte)
+{
+    crc = (eos_u16_t)((crc << 4) ^ eos_crc16_table[(crc >> 12) ^ (byte >> 4)]);
+    crc = (eos_u16_t)((crc << 4) ^ eos_crc16_table[(crc >> 12) ^ (byte & 0x0f)]);
+
+    return crc;
+}
+
+static void eos_stream_frame_start(eos_bridge_stream_t * const me)
+{
+    me->tx_len = 1;
+    me->tx_code = 0;
+    me->tx_run = 1;
+    me->tx_crc = 0xffff;
+    me->tx_count = 0;
+}
+
+// 逐字节COBS编码。码字节的位置先空出，其后的非零字节数确定后再填入。
+static void eos_stream_put(eos_bridge_stream_t * const me, eos_u8_t byte)
+{
+    eos_u8_t *tx = me->tx[me->tx_index];
+
+    if (byte != 0) {
+        tx[me->tx_len ++] = byte;
+        me->tx_run ++;
+        if (me->tx_run != 0xff) {
+            return;
+        }
+    }
+    tx[me->tx_code] = me->tx_run;
+    me->tx_code = me->tx_len ++;
+    me->tx_run = 1;
+}
+
+static void eos_stream_put_crc(eos_bridge_stream_t * const me, eos_u8_t byte)
+{
+    me->tx_crc = eos_crc16(me->tx_crc, byte);
+    eos_stream_put(me, byte);
+}
+
+// 封闭正在填充的帧，交由调度器发送，之后的事件写入另一个缓冲区
+static void eos_stream_seal(eos_bridge_stream_t * const me)
+{
+    eos_u16_t crc = me->tx_crc;
+    eos_u8_t *tx;
+
+    eos_stream_put(me, (eos_u8_t)crc);
+    eos_stream_put(me, (eos_u8_t)(crc >> 8));
+    tx = me->tx[me->tx_index];
+    tx[me->tx_code] = me->tx_run;
+    tx[me->tx_len ++] = 0;
+
+    me->tx_sealed = me->tx_len;
+    me->tx_index = 1 - me->tx_index;
+}
+
+// 在临界区内调用
+static void eos_stream_append(eos_topic_t topic, void const *data, eos_u32_t size)
+{
+    eos_bridge_stream_t *me = &eos.stream;
+    eos_u32_t need = EOS_STREAM_WORST(EOS_STREAM_HEADER + size) + EOS_STREAM_TRAILER;
+
+    if (me->tx_len + need > EOS_SIZE_BRIDGE_FRAME) {
+        // 当前帧已满，另一个缓冲区还未发送，或事件大于一帧，丢弃
+        if (me->tx_count == 0 || me->tx_sealed != 0 ||
+            1 + need > EOS_SIZE_BRIDGE_FRAME) {
+            me->lost ++;
+            return;
+        }
+        eos_stream_seal(me);
+        eos_stream_frame_start(me);
+    }
+
+    eos_stream_put_crc(me, (eos_u8_t)topic);
+    eos_stream_put_crc(me, (eos_u8_t)(topic >> 8));
+    eos_stream_put_crc(me, (eos_u8_t)size);
+    eos_stream_put_crc(me, (eos_u8_t)(size >> 8));
+    for (eos_u32_t i = 0; i < size; i ++) {
+        eos_stream_put_crc(me, ((eos_u8_t const *)data)[i]);
+    }
+    me->tx_count ++;
+}
+
+void eos_bridge_stream_start(void)
+{
+    eos_bridge_stream_t *me = &eos.stream;
+
+    eos_port_critical_enter();
+    me->tx_index = 0;
+    me->tx_sealed = 0;
+    eos_stream_frame_start(me);
+    me->rx_len = 0;
+    me->rx_remain = 0;
+    me->rx_code = 0;
+    me->rx_overflow = EOS_False;
+    me->lost = 0;
+    me->error = 0;
+    me->enabled = EOS_True;
+    eos_port_critical_exit();
+}
+
+void eos_bridge_flush(void)
+{
+    eos_bridge_stream_t *me = &eos.stream;
+
+    if (me->enabled == EOS_False) {
+        return;
+    }
+
+    // 先发送已封闭的帧，再发送正在填充的帧
+    while (1) {
+        eos_port_critical_enter();
+        if (me->tx_sealed == 0 && me->tx_count != 0) {
+            eos_stream_seal(me);
+            eos_stream_frame_start(me);
+        }
+        eos_u8_t index = 1 - me->tx_index;
+        eos_u16_t len = me->tx_sealed;
+        eos_port_critical_exit();
+        if (len == 0) {
+            return;
+        }
+
+        // 发送期间，发布者写入另一个缓冲区
+        eos_port_bridge_send(me->tx[index], len);
+
+        eos_port_critical_enter();
+        me->tx_sealed = 0;
+        eos_port_critical_exit();
+    }
+}
+
+// 校验通过后，逐个发布帧内的事件
+static void eos_stream_frame_end(eos_bridge_stream_t * const me)
+{
+    eos_u8_t *rx = me->rx;
+    eos_u16_t crc = 0xffff;
+    eos_u32_t len = me->rx_len;
+
+    if (me->rx_overflow != EOS_False || me->rx_remain != 0 || len < 2) {
+        // 连续的0x00不是错误
+        if (me->rx_overflow != EOS_False || len != 0 || me->rx_code != 0) {
+            me->error ++;
+        }
+        return;
+    }
+    len -= 2;
+    for (eos_u32_t i = 0; i < len; i ++) {
+        crc = eos_crc16(crc, rx[i]);
+    }
+    if (crc != (eos_u16_t)(rx[len] | (rx[len + 1] << 8))) {
+        me->error ++;
+        return;
+    }
+
+    eos_u32_t i = 0;
+    while (i + EOS_STREAM_HEADER <= len) {
+        eos_topic_t topic = (eos_topic_t)(rx[i] | (rx[i + 1] << 8));
+        eos_u32_t size = (eos_u32_t)(rx[i + 2] | (rx[i + 3] << 8));
+        i += EOS_STREAM_HEADER;
+        if (i + size > len) {
+            me->error ++;
+            return;
+        }
+#if (EOS_USE_PUB_SUB != 0)
+        if (topic >= Event_User && topic < eos.topic_max)
+#else
+        if (topic >= Event_User)
+#endif
+        {
+            // 后续字节随时到达，无法保留，堆空间不足时丢弃
+            if (eos_event_pub_local(topic, &rx[i], size) == (eos_s8_t)EosRunErr_MallocFail) {
+                me->lost ++;
+            }
+        }
+        i += size;
+    }
+}
+
+// 流式COBS解码，直接解码到帧缓冲区，不申请内存
+void eos_bridge_stream_feed(void const *data, eos_u32_t size)
+{
+    eos_bridge_stream_t *me = &eos.stream;
+    eos_u8_t const *bytes = (eos_u8_t const *)data;
+
+    for (eos_u32_t i = 0; i < size; i ++) {
+        eos_u8_t byte = bytes[i];
+        if (byte == 0) {
+            eos_stream_frame_end(me);
+            me->rx_len = 0;
+            me->rx_remain = 0;
+            me->rx_code = 0;
+            me->rx_overflow = EOS_False;
+            continue;
+        }
+        if (me->rx_overflow != EOS_False) {
+            continue;
+        }
+        if (me->rx_remain == 0) {
+            // 码字节，上一个数据块之后是一个0x00，0xff的块除外
+            if (me->rx_code != 0 && me->rx_code != 0xff) {
+                if (me->rx_len >= EOS_SIZE_BRIDGE_FRAME) {
+                    me->rx_overflow = EOS_True;
+                    continue;
+                }
+                me->rx[me->rx_len ++] = 0;
+            }
+            me->rx_code = byte;
+            me->rx_remain = byte - 1;
+            continue;
+        }
+        if (me->rx_len >= EOS_SIZE_BRIDGE_FRAME) {
+            me->rx_overflow = EOS_True;
+            continue;
+        }
+        me->rx[me->rx_len ++] = byte;
+        me->rx_remain --;
+    }
+}
+#endif
+#endif
+
 /* for unittest ------------------------------------------------------------- */
 void * eos_get_framework(void)
 {
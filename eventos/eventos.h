@@ -50,6 +50,30 @@ extern "C" {
 #define EOS_MAX_ACTORS                          8       // 默认最多8个Actor
 #endif
 
+#ifndef EOS_SIZE_DISPATCH_BATCH
+#define EOS_SIZE_DISPATCH_BATCH                 1       // 默认每轮调度只处理一个事件
+#endif
+
+#ifndef EOS_USE_IDLE_WAKEUP
+#define EOS_USE_IDLE_WAKEUP                     0       // 默认空闲回调不阻塞，无需唤醒
+#endif
+
+#ifndef EOS_USE_MULTI_WORKER
+#define EOS_USE_MULTI_WORKER                    0       // 默认所有Actor在eos_run()中调度
+#endif
+
+#ifndef EOS_MAX_WORKERS
+#define EOS_MAX_WORKERS                         1       // 默认只有一个worker
+#endif
+
+#ifndef EOS_USE_WORK_STEALING
+#define EOS_USE_WORK_STEALING                   0       // 默认worker只分发绑定到它的Actor
+#endif
+
+#ifndef EOS_USE_PREEMPT
+#define EOS_USE_PREEMPT                         0       // 默认协作式调度，Actor之间不抢占
+#endif
+
 #ifndef EOS_USE_ASSERT
 #define EOS_USE_ASSERT                          1       // 默认打开断言
 #endif
@@ -58,22 +82,106 @@ extern "C" {
 #define EOS_USE_SM_MODE                         0       // 默认关闭状态机
 #endif
 
+#ifndef EOS_USE_FSM_TABLE
+#define EOS_USE_FSM_TABLE                       0       // 默认关闭表驱动的平面状态机
+#endif
+
+#ifndef EOS_USE_HSM_CACHE
+#define EOS_USE_HSM_CACHE                       0       // 默认层次状态机转换时逐层探测父状态
+#endif
+
+#ifndef EOS_MAX_HSM_STATES
+#define EOS_MAX_HSM_STATES                      32      // 默认缓存的层次状态数量
+#endif
+
+#ifndef EOS_USE_HSM_TRAN_CACHE
+#define EOS_USE_HSM_TRAN_CACHE                  0       // 默认每次转换都计算退出与进入的路径
+#endif
+
+#ifndef EOS_SIZE_HSM_TRAN_CACHE
+#define EOS_SIZE_HSM_TRAN_CACHE                 4       // 默认每个状态机缓存的转换数量
+#endif
+
+#ifndef EOS_SIZE_HSM_TRAN_PATH
+#if (EOS_MAX_HSM_NEST_DEPTH < 4)
+#define EOS_SIZE_HSM_TRAN_PATH                  EOS_MAX_HSM_NEST_DEPTH
+#else
+#define EOS_SIZE_HSM_TRAN_PATH                  4       // 默认缓存的转换最多进入4层
+#endif
+#endif
+
+#ifndef EOS_USE_HSM_HISTORY
+#define EOS_USE_HSM_HISTORY                     0       // 默认关闭历史状态
+#endif
+
+#ifndef EOS_MAX_HSM_HISTORY
+#define EOS_MAX_HSM_HISTORY                     4       // 默认每个状态机记录历史的组合状态数量
+#endif
+
 #ifndef EOS_USE_PUB_SUB
 #define EOS_USE_PUB_SUB                         0       // 默认关闭发布-订阅机制
 #endif
 
+#ifndef EOS_USE_SUB_CONST
+#define EOS_USE_SUB_CONST                       0       // 默认订阅表只在运行时建立
+#endif
+
 #ifndef EOS_USE_TIME_EVENT
 #define EOS_USE_TIME_EVENT                      0       // 默认关闭时间事件
 #endif
 
+#ifndef EOS_USE_TIMER_MIN_HEAP
+#define EOS_USE_TIMER_MIN_HEAP                  0       // 默认时间事件使用数组线性查找
+#endif
+
+#ifndef EOS_MAX_UNBLOCKED_TOPIC
+#define EOS_MAX_UNBLOCKED_TOPIC                 4       // 默认不可阻塞事件的数量
+#endif
+
+#ifndef EOS_SIZE_TOPIC_QUEUE
+#define EOS_SIZE_TOPIC_QUEUE                    16      // 默认不携带数据的事件队列深度
+#endif
+
+#ifndef EOS_USE_PUB_INGRESS
+#define EOS_USE_PUB_INGRESS                     0       // 默认eos_event_pub_topic()直接进入事件队列
+#endif
+
+#ifndef EOS_SIZE_PUB_INGRESS
+#define EOS_SIZE_PUB_INGRESS                    16      // 默认入口环深度
+#endif
+
 #ifndef EOS_USE_EVENT_DATA
 #define EOS_USE_EVENT_DATA                      0       // 默认关闭时间事件
 #endif
 
+#ifndef EOS_USE_HEAP_BIN
+#define EOS_USE_HEAP_BIN                        0       // 默认关闭小块内存的分级空闲链表
+#endif
+
+#ifndef EOS_USE_EVENT_REF
+#define EOS_USE_EVENT_REF                       0       // 默认关闭事件数据的引用计数
+#endif
+
 #ifndef EOS_USE_EVENT_BRIDGE
 #define EOS_USE_EVENT_BRIDGE                    0       // 默认关闭事件桥
 #endif
 
+#ifndef EOS_SIZE_BRIDGE
+#define EOS_SIZE_BRIDGE                         1024    // 默认事件桥每个方向的环形缓冲区字节数
+#endif
+
+#ifndef EOS_MAX_BRIDGE_TOPIC
+#define EOS_MAX_BRIDGE_TOPIC                    8       // 默认经事件桥转发的主题的数量
+#endif
+
+#ifndef EOS_USE_BRIDGE_STREAM
+#define EOS_USE_BRIDGE_STREAM                   0       // 默认事件桥不使用字节流（串口等）
+#endif
+
+#ifndef EOS_SIZE_BRIDGE_FRAME
+#define EOS_SIZE_BRIDGE_FRAME                   256     // 默认字节流中一帧的最大字节数
+#endif
+
 #include "eventos_def.h"
 
 /* data struct -------------------------------------------------------------- */
@@ -98,6 +206,25 @@ typedef eos_u8_t                        eos_topic_t;
 typedef eos_u16_t                       eos_topic_t;
 #endif
 
+#if (EOS_USE_PUB_SUB != 0 && EOS_USE_SUB_CONST != 0)
+// 编译期订阅表 ----------------------------------------------------------------
+// 以X宏描述主题与其订阅者（Actor的优先级），生成主题枚举与只读的订阅表：
+//     #define APP_TOPICS(X) X(Event_Key, EOS_SUB_ACTOR(Prio_Ui) | EOS_SUB_ACTOR(Prio_Log))
+//                           X(Event_Tick, EOS_SUB_ACTOR(Prio_Ui))
+//     EOS_TOPIC_ENUM(APP_TOPICS, Event_Max);              // 头文件中
+//     EOS_SUB_TABLE(app_sub_table, APP_TOPICS, Event_Max); // 某个源文件中
+// 描述也可以由tools/topic_gen.py从文本文件生成。
+#define EOS_SUB_ACTOR(priority_)                ((eos_sub_t)1 << (priority_))
+#define EOS_TOPIC_ENUM_ITEM(topic_, sub_)       topic_,
+#define EOS_TOPIC_SUB_ITEM(topic_, sub_)        [topic_] = (eos_sub_t)(sub_),
+// 第一个主题为Event_User，max_为主题的数量
+#define EOS_TOPIC_ENUM(list_, max_)                                             \
+    enum { max_##_Base = Event_User - 1, list_(EOS_TOPIC_ENUM_ITEM) max_ }
+// 未列出的主题（包括系统事件）没有订阅者
+#define EOS_SUB_TABLE(name_, list_, max_)                                       \
+    eos_sub_t const name_[max_] = { list_(EOS_TOPIC_SUB_ITEM) }
+#endif
+
 // 状态返回值的定义
 #if (EOS_USE_SM_MODE != 0)
 typedef enum eos_ret {
@@ -134,15 +261,13 @@ typedef struct eos_actor {
     eos_u32_t magic;
 #endif
 #if (EOS_MCU_TYPE == 32 || EOS_MCU_TYPE == 16)
-    eos_u32_t priority              : 5;
+    eos_u32_t priority              : 6;
     eos_u32_t mode                  : 1;
     eos_u32_t enabled               : 1;
-    eos_u32_t reserve               : 1;
 #else
-    eos_u8_t priority               : 5;
+    eos_u8_t priority               : 6;
     eos_u8_t mode                   : 1;
     eos_u8_t enabled                : 1;
-    eos_u8_t reserve                : 1;
 #endif
 } eos_actor_t;
 
@@ -153,18 +278,119 @@ typedef struct eos_reactor {
 } eos_reactor_t;
 
 #if (EOS_USE_SM_MODE != 0)
+#if (EOS_USE_HSM_TRAN_CACHE != 0)
+// 缓存的转换：由处理事件的状态source转换到target时，先退出到最近公共祖先lca（不含），
+// 再由上至下依次进入enter中的各层状态。进入多于EOS_SIZE_HSM_TRAN_PATH层的转换不缓存。
+typedef struct eos_sm_tran {
+    eos_state_handler source;
+    eos_state_handler target;
+    eos_state_handler lca;
+    eos_state_handler enter[EOS_SIZE_HSM_TRAN_PATH];
+    eos_u8_t enter_num;
+} eos_sm_tran_t;
+#endif
+
+#if (EOS_USE_HSM_HISTORY != 0)
+// 组合状态的历史：最后一次退出state时，其中活动的直接子状态（浅历史）与叶状态（深历史），
+// 由分发中的退出逐层记下
+typedef struct eos_sm_history {
+    eos_state_handler state;
+    eos_state_handler shallow;
+    eos_state_handler deep;
+} eos_sm_history_t;
+#endif
+
 // 状态机类
 typedef struct eos_sm {
     eos_actor_t super;
     volatile eos_state_handler state;
+#if (EOS_USE_HSM_TRAN_CACHE != 0)
+    eos_sm_tran_t tran[EOS_SIZE_HSM_TRAN_CACHE];   // 最近使用的转换
+    eos_u8_t tran_count;
+    eos_u8_t tran_next;                             // 缓存满时下一个被替换的
+#endif
+#if (EOS_USE_HSM_HISTORY != 0)
+    eos_sm_history_t history[EOS_MAX_HSM_HISTORY];  // 记录历史的组合状态
+    eos_u8_t history_count;
+#endif
 } eos_sm_t;
 #endif
 
+#if (EOS_USE_FSM_TABLE != 0)
+// 表驱动的平面状态机 ------------------------------------------------------------
+// 状态为从0开始的编号，转换表为const的二维数组[状态][主题 - Event_User]，可放在Flash中。
+// 每个事件直接以下标查表，执行动作后转换到目标状态，表中为空的事件被忽略。
+struct eos_fsm;
+typedef void (* eos_fsm_action_t)(struct eos_fsm * const me, eos_event_t const * const e);
+
+typedef struct eos_fsm_tran {
+    eos_fsm_action_t action;                // 可为EOS_NULL
+    eos_u8_t target;                        // 目标状态 + 1，为0时不转换
+} eos_fsm_tran_t;
+
+// 状态的进入与退出动作，可为EOS_NULL。参数为引起转换的事件，启动时为Event_Null。
+typedef struct eos_fsm_state {
+    eos_fsm_action_t enter;
+    eos_fsm_action_t exit;
+} eos_fsm_state_t;
+
+typedef struct eos_fsm_table {
+    eos_fsm_tran_t const *tran;             // [state_num][topic_num]
+    eos_fsm_state_t const *state;           // [state_num]，可为EOS_NULL
+    eos_u8_t state_num;
+    eos_topic_t topic_num;                  // 表中的主题为Event_User ~ Event_User + topic_num - 1
+} eos_fsm_table_t;
+
+typedef struct eos_fsm {
+    eos_reactor_t super;
+    eos_fsm_table_t const *table;
+    eos_u8_t state;
+} eos_fsm_t;
+
+// 生成转换表的宏：
+//     static const eos_fsm_tran_t tran[State_Max][Event_Max - Event_User] = {
+//         EOS_FSM_ROW(State_Idle,
+//             EOS_FSM_ON(Event_Open, open_start, State_Wait),
+//             EOS_FSM_ON(Event_Poll, poll_count, EOS_FSM_STAY)),
+//         ...
+//     };
+//     static const eos_fsm_table_t table = EOS_FSM_TABLE(tran, state, State_Max, Event_Max);
+#define EOS_FSM_STAY                            (-1)    // 只执行动作，不退出也不进入状态
+#define EOS_FSM_ROW(state_, ...)                [state_] = { __VA_ARGS__ }
+#define EOS_FSM_ON(topic_, action_, target_)                                    \
+    [(topic_) - Event_User] = { (eos_fsm_action_t)(action_), (eos_u8_t)((target_) + 1) }
+#define EOS_FSM_TABLE(tran_, state_, state_num_, topic_max_)                    \
+    { &(tran_)[0][0], (state_), (state_num_), (eos_topic_t)((topic_max_) - Event_User) }
+#define EOS_FSM_ACTION_CAST(action)             ((eos_fsm_action_t)(action))
+#endif
+
+#if (EOS_USE_EVENT_BRIDGE != 0)
+// 事件桥的单向环形缓冲区，位于两个EventOS实例（如两个进程）的共享内存中。
+// 记录为4字节对齐的{主题, 长度, 数据}，不足以在尾部连续存放时，以填充记录跳到开头。
+typedef struct eos_bridge_ring {
+    eos_u32_t head;                         // 已写入的字节数，只由发送方修改
+    eos_u32_t tail;                         // 已读取的字节数，只由接收方修改
+    eos_u32_t doorbell;                     // 门铃计数，接收方可在其上等待（如futex）
+    eos_u32_t lost;                         // 缓冲区已满而丢弃的事件数
+    eos_u32_t data[EOS_SIZE_BRIDGE / 4];
+} eos_bridge_ring_t;
+
+// 共享内存，两个方向各一个环形缓冲区。实例side发送到ring[side]，从ring[1 - side]接收。
+typedef struct eos_bridge {
+    eos_bridge_ring_t ring[2];
+} eos_bridge_t;
+#endif
+
 // api -------------------------------------------------------------------------
 // 对框架进行初始化，在各状态机初始化之前调用。
 void eos_init(void);
 #if (EOS_USE_PUB_SUB != 0)
-void eos_sub_init(eos_mcu_t *flag_sub, eos_topic_t topic_max);
+void eos_sub_init(eos_sub_t *flag_sub, eos_topic_t topic_max);
+#endif
+#if (EOS_USE_PUB_SUB != 0 && EOS_USE_SUB_CONST != 0)
+// 使用编译期生成的只读订阅表，可放在Flash中，省去运行时的订阅表与订阅调用。需要动态订阅时，
+// 再以eos_sub_init()设置运行时的订阅表作为叠加层，eos_event_sub()只修改叠加层。
+void eos_sub_init_const(eos_sub_t const *table, eos_topic_t topic_max);
 #endif
 // 启动框架，放在main函数的末尾。
 void eos_run(void);
@@ -172,15 +398,72 @@ void eos_run(void);
 // 停止框架后，框架会在执行完当前状态机的当前事件后，清空各状态机事件队列，清空事件池，
 // 不再执行任何功能，直至框架被再次启动。
 void eos_stop(void);
-// 延时，不屏蔽事件接收（毫秒级延时，释放CPU控制权）
+#if (EOS_USE_MULTI_WORKER != 0)
+// 将Actor绑定到worker线程，在eos_run()之前调用。未绑定的Actor在worker 0，即eos_run()
+// 所在的线程中运行。不同worker的Actor并行处理事件，同一Actor的事件总是在其worker中依次处理。
+void eos_worker_bind(eos_actor_t * const me, eos_u8_t worker);
+// 已绑定了Actor的worker的数量
+eos_u8_t eos_worker_num(void);
+// worker线程的主循环，由port在eos_hook_start()中为worker 1 ~ eos_worker_num() - 1
+// 各创建一个线程调用。框架停止后返回。
+void eos_worker_run(eos_u8_t worker);
+#if (EOS_USE_WORK_STEALING != 0)
+// 打开工作窃取，共worker_num个worker，在eos_worker_bind()之后、eos_run()之前调用。
+// worker没有自己的事件时，窃取其他worker的就绪Actor来分发，同一Actor仍不会在两个
+// worker中同时运行。
+void eos_worker_steal(eos_u8_t worker_num);
+#endif
+#endif
+#if (EOS_USE_PREEMPT != 0)
+// 抢占式调度。Actor运行期间，有更高优先级的Actor就绪时，框架调用eos_port_preempt()，
+// port随后在中断尾部（如PendSV）调用eos_preempt()，立即分发这些Actor的事件，被抢占的
+// Actor在它们处理完毕后继续运行。多于一个worker时不抢占。
+void eos_preempt(void);
+// 优先级天花板锁，用于保护Actor之间共享的资源。加锁后，优先级不高于ceiling的Actor
+// 不能抢占当前Actor。返回之前的天花板，解锁时交给eos_unlock()。
+eos_u8_t eos_lock(eos_u8_t ceiling);
+void eos_unlock(eos_u8_t prev);
+#endif
+#if (EOS_USE_TIME_EVENT != 0)
+// 在事件处理函数中调用，当前Actor延时，立即返回，不阻塞其他Actor的调度。当前事件处理完毕
+// 后，该Actor暂停处理事件，延时完毕后继续。
+// 延时，不屏蔽事件接收（毫秒级延时，期间发布的事件在延时完毕后依次处理）
 void eos_delay(eos_u32_t time_ms);
-// 延时，屏蔽事件的接收（毫秒级延时，释放CPU控制权），直到延时完毕。
+// 延时，屏蔽事件的接收（毫秒级延时，期间发布的事件被丢弃，不可阻塞事件除外），直到延时完毕。
 void eos_delay_unsub_event(eos_u32_t time_ms);
-#if (EOS_USE_TIME_EVENT != 0)
+#define EOS_TIME_FOREVER                EOS_U32_MAX
 // 系统当前时间
 eos_u32_t eos_time(void);
 // 系统滴答
 void eos_tick(void);
+// 系统时间前进elapsed_ms毫秒，用于低功耗或休眠唤醒后一次性补偿时间（Tickless）。
+void eos_tick_advance(eos_u32_t elapsed_ms);
+// 距离最近的时间事件到期的毫秒数，已到期返回0，没有时间事件返回EOS_TIME_FOREVER。
+// 空闲时可据此休眠，而不必每毫秒唤醒一次。
+eos_u32_t eos_time_next(void);
+#endif
+
+#if (EOS_USE_EVENT_BRIDGE != 0)
+// 关于事件桥 -------------------------------------------------------------------
+// 初始化共享内存，由创建共享内存的一方，在任一实例连接之前调用一次。
+void eos_bridge_shm_init(eos_bridge_t * const shm);
+// 连接到共享内存，两个实例的side分别为0和1，在eos_init()之后调用。
+// 接收到的事件在调度时发布到本实例，不会再被转发回去。
+void eos_bridge_attach(eos_bridge_t * const shm, eos_u8_t side);
+// 将主题转发到对端实例。发布时，数据从发布者的缓冲区拷贝到共享内存，不经过本实例的堆；
+// 对端在调度时再将其拷贝到自己的堆中，作为普通事件发布。
+void eos_bridge_export(eos_topic_t topic);
+#if (EOS_USE_BRIDGE_STREAM != 0)
+// 经字节流（UART、USB CDC、管道等）转发，可与共享内存同时使用。
+// 一帧为COBS编码的{主题, 长度, 数据}*N + CRC16，以0x00结尾。一轮调度中转发的事件合为一帧，
+// 由调度器经eos_port_bridge_send()发送。
+void eos_bridge_stream_start(void);
+// 将收到的字节交给事件桥（只能有一个调用者，可在中断中调用）。帧校验通过后，其中的事件
+// 发布到本实例，不会再被转发回去。
+void eos_bridge_stream_feed(void const *data, eos_u32_t size);
+// 立即发送已缓存的事件，调度器在每轮调度时自动调用。
+void eos_bridge_flush(void);
+#endif
 #endif
 
 // 关于Reactor -----------------------------------------------------------------
@@ -205,11 +488,33 @@ eos_ret_t eos_state_top(eos_sm_t * const me, eos_event_t const * const e);
 #define EOS_TRAN(target)            eos_tran((eos_sm_t * )me, (eos_state_handler)target)
 #define EOS_SUPER(super)            eos_super((eos_sm_t * )me, (eos_state_handler)super)
 #define EOS_STATE_CAST(state)       ((eos_state_handler)(state))
+
+#if (EOS_USE_HSM_HISTORY != 0)
+// 为组合状态记录历史，一般在初始状态中调用。之后转换到其历史时，浅历史进入最后一次退出时
+// 活动的直接子状态并执行其初始转换，深历史直接进入最后活动的叶状态，不再逐层初始转换。
+// 尚未退出过该状态时，与转换到该状态相同。
+void eos_sm_history(eos_sm_t * const me, eos_state_handler state);
+eos_ret_t eos_tran_history(eos_sm_t * const me, eos_state_handler state);
+eos_ret_t eos_tran_deep_history(eos_sm_t * const me, eos_state_handler state);
+
+#define EOS_HISTORY(state)          eos_sm_history((eos_sm_t * )me, (eos_state_handler)state)
+#define EOS_TRAN_HISTORY(target)    eos_tran_history((eos_sm_t * )me, (eos_state_handler)target)
+#define EOS_TRAN_DEEP_HISTORY(target)                                          \
+    eos_tran_deep_history((eos_sm_t * )me, (eos_state_handler)target)
+#endif
+#endif
+
+#if (EOS_USE_FSM_TABLE != 0)
+// 表驱动的平面状态机，基于Reactor，启动时执行初始状态的进入动作
+void eos_fsm_init(eos_fsm_t * const me, eos_u8_t priority, eos_fsm_table_t const * const table);
+void eos_fsm_start(eos_fsm_t * const me, eos_u8_t state_init);
 #endif
 
 // 关于事件 -------------------------------------------------
+#if (EOS_USE_TIME_EVENT != 0)
 // 设置不可阻塞事件（在延时时，此类事件进入，延时结束，对此类事件进行立即响应）
 void eos_event_set_unblocked(eos_topic_t topic);
+#endif
 #if (EOS_USE_PUB_SUB != 0)
 // 事件订阅
 void eos_event_sub(eos_actor_t * const me, eos_topic_t topic);
@@ -221,12 +526,22 @@ void eos_event_unsub(eos_actor_t * const me, eos_topic_t topic);
 #define EOS_EVENT_UNSUB(_evt)             eos_event_unsub(&(me->super.super), _evt)
 #endif
 
-// 注：只有下面两个函数能在中断服务函数中使用，其他都没有必要。如果使用，可能会导致崩溃问题。
+// 注：只有下面几个函数能在中断服务函数中使用，其他都没有必要。如果使用，可能会导致崩溃问题。
 // 发布事件（仅主题）
 void eos_event_pub_topic(eos_topic_t topic);
 #if (EOS_USE_EVENT_DATA != 0)
 // 发布事件（携带数据）
 void eos_event_pub(eos_topic_t topic, void *data, eos_u32_t size);
+// 零拷贝发布事件：先申请事件数据空间，直接写入数据后，再提交发布。
+// 申请失败时返回EOS_NULL；申请成功后，必须调用eos_event_commit。
+void * eos_event_alloc(eos_topic_t topic, eos_u32_t size);
+void eos_event_commit(void *data);
+#if (EOS_USE_EVENT_REF != 0)
+// 在事件处理函数中，持有当前事件的数据，返回数据指针（不携带数据的事件返回EOS_NULL）。
+// 持有期间数据不会被释放，使用完毕后，必须调用eos_event_unref。
+void * eos_event_ref(eos_event_t const * const e);
+void eos_event_unref(void *data);
+#endif
 #endif
 
 #if (EOS_USE_TIME_EVENT != 0)
@@ -242,6 +557,27 @@ void eos_event_time_cancel(eos_topic_t topic);
 void eos_port_critical_enter(void);
 void eos_port_critical_exit(void);
 void eos_port_assert(eos_u32_t error_id);
+#if (EOS_USE_IDLE_WAKEUP != 0)
+// 有事件发布或框架停止时调用（可能在临界区内），用于唤醒阻塞在空闲回调中的主循环。
+void eos_port_wakeup(void);
+#endif
+
+#if (EOS_USE_PREEMPT != 0)
+// 请求抢占（在临界区内调用，可能来自中断或其他线程）。port应在退出临界区与中断后，尽快在
+// 调度器所在的上下文中调用eos_preempt()，如单核上的PendSV，或eos_run()所在的线程，不能在
+// 请求抢占的其他线程中直接调用。
+void eos_port_preempt(void);
+#endif
+
+#if (EOS_USE_EVENT_BRIDGE != 0)
+// 敲门铃，通知对端有新的事件（每批事件只调用一次，在门铃计数增加之后调用）。
+// 对端可据此唤醒其主循环，之后在调度时一次取出全部事件。
+void eos_port_bridge_notify(eos_bridge_ring_t * const ring);
+#if (EOS_USE_BRIDGE_STREAM != 0)
+// 发送一帧，返回后缓冲区即被重用，port需在返回前完成发送或复制数据。
+void eos_port_bridge_send(eos_u8_t const *data, eos_u32_t size);
+#endif
+#endif
 
 /* hook --------------------------------------------------------------------- */
 // 空闲回调函数
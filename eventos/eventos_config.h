@@ -40,6 +40,27 @@
 #define EOS_TEST_PLATFORM                       32
 #define EOS_TICK_MS                             1
 #define EOS_USE_MAGIC                           0
+#define EOS_SIZE_DISPATCH_BATCH                 1           // 每轮调度中，同一Actor最多连续处理的事件数
+#define EOS_USE_IDLE_WAKEUP                     1           // 发布事件时调用eos_port_wakeup()，空闲回调可阻塞等待
+
+/* Multi-worker Configuration ----------------------------------------------- */
+// 多线程调度与工作窃取，需要可重入的临界区，仅用于posix。默认关闭，单元测试在编译时打开。
+#ifndef EOS_USE_MULTI_WORKER
+#define EOS_USE_MULTI_WORKER                    0
+#endif
+#if (EOS_USE_MULTI_WORKER != 0)
+    #define EOS_MAX_WORKERS                     4           // worker线程的最大数量
+    #ifndef EOS_USE_WORK_STEALING
+    #define EOS_USE_WORK_STEALING               0           // 空闲的worker窃取其他worker的就绪Actor
+    #endif
+#endif
+
+/* Preemption Configuration ------------------------------------------------- */
+// 更高优先级的Actor就绪时立即抢占，需要port实现eos_port_preempt()。默认关闭，单元测试
+// 在编译时打开。
+#ifndef EOS_USE_PREEMPT
+#define EOS_USE_PREEMPT                         0
+#endif
 
 /* Assert Configuration ----------------------------------------------------- */
 #define EOS_USE_ASSERT                          1
@@ -48,24 +69,79 @@
 #define EOS_USE_SM_MODE                         1
 #define EOS_USE_HSM_MODE                        1
 #if (EOS_USE_SM_MODE != 0 && EOS_USE_HSM_MODE != 0)
+// 最大嵌套层数。打开EOS_USE_HSM_CACHE时可为2 ~ 255，不随层数占用RAM；否则为2 ~ 16，每次
+// 分发在栈上占用(层数 + 1)个指针。默认为4，单元测试在编译时设为8。
+#ifndef EOS_MAX_HSM_NEST_DEPTH
 #define EOS_MAX_HSM_NEST_DEPTH                  4
 #endif
+#ifndef EOS_USE_HSM_CACHE
+#define EOS_USE_HSM_CACHE                       0           // 缓存各状态的父状态与层数，转换时不再调用状态函数探测，默认关闭
+#endif
+#define EOS_MAX_HSM_STATES                      32          // 缓存的状态数量，2的幂，其中一个为eos_state_top
+#ifndef EOS_USE_HSM_TRAN_CACHE
+#define EOS_USE_HSM_TRAN_CACHE                  0           // 每个状态机缓存转换的退出与进入路径，需要EOS_USE_HSM_CACHE，默认关闭
+#endif
+#define EOS_SIZE_HSM_TRAN_CACHE                 4           // 每个状态机缓存的转换数量
+// 缓存的转换最多进入的层数，进入更多层的转换不缓存。每个状态机的转换缓存占用
+// EOS_SIZE_HSM_TRAN_CACHE * (EOS_SIZE_HSM_TRAN_PATH + 3)个指针，与EOS_MAX_HSM_NEST_DEPTH无关。
+#define EOS_SIZE_HSM_TRAN_PATH                  4
+#ifndef EOS_USE_HSM_HISTORY
+#define EOS_USE_HSM_HISTORY                     0           // 浅历史与深历史，需要EOS_USE_HSM_CACHE，默认关闭
+#endif
+#define EOS_MAX_HSM_HISTORY                     4           // 每个状态机记录历史的组合状态数量
+#endif
+#ifndef EOS_USE_FSM_TABLE
+#define EOS_USE_FSM_TABLE                       0           // 表驱动的平面状态机，转换表可放在Flash中，默认关闭
+#endif
 
 /* Publish & Subscribe Configuration ---------------------------------------- */
 #define EOS_USE_PUB_SUB                         1
+#ifndef EOS_USE_SUB_CONST
+#define EOS_USE_SUB_CONST                       0           // 支持编译期生成的只读订阅表，默认关闭
+#endif
 
 /* Time Event Configuration ------------------------------------------------- */
 #define EOS_USE_TIME_EVENT                      1
 #if (EOS_USE_TIME_EVENT != 0)
+    #ifndef EOS_MAX_TIME_EVENT
     #define EOS_MAX_TIME_EVENT                  4           // 时间事件的数量
+    #endif
+    #ifndef EOS_USE_TIMER_MIN_HEAP
+    #define EOS_USE_TIMER_MIN_HEAP              0           // 时间事件使用最小堆管理，适合大量定时器，默认关闭
+    #endif
+    #define EOS_MAX_UNBLOCKED_TOPIC             4           // 不可阻塞事件的数量，用于eos_delay_unsub_event()
+#endif
+
+/* Topic Event Configuration ------------------------------------------------ */
+#define EOS_SIZE_TOPIC_QUEUE                    32          // 不携带数据的事件的队列深度，2的幂
+#ifndef EOS_USE_PUB_INGRESS
+#define EOS_USE_PUB_INGRESS                     0           // eos_event_pub_topic()经无锁入口环发布，适合中断与多线程，默认关闭
+#endif
+#if (EOS_USE_PUB_INGRESS != 0)
+    #define EOS_SIZE_PUB_INGRESS                16          // 入口环的深度，2的幂
 #endif
 
 /* Event's Data Configuration ----------------------------------------------- */
 #define EOS_USE_EVENT_DATA                      1
 #define EOS_SIZE_HEAP                           32767       // 设定堆大小
+#ifndef EOS_USE_HEAP_BIN
+#define EOS_USE_HEAP_BIN                        0           // 小块内存使用分级空闲链表，默认关闭
+#endif
+#ifndef EOS_USE_EVENT_REF
+#define EOS_USE_EVENT_REF                       0           // 事件数据的引用计数，默认关闭
+#endif
 
 /* Event Bridge Configuration ----------------------------------------------- */
+// 经共享内存与其他实例（进程）转发事件。默认关闭，单元测试在编译时打开。
+#ifndef EOS_USE_EVENT_BRIDGE
 #define EOS_USE_EVENT_BRIDGE                    0
+#endif
+#if (EOS_USE_EVENT_BRIDGE != 0)
+    #define EOS_SIZE_BRIDGE                     4096        // 每个方向的环形缓冲区字节数，2的幂
+    #define EOS_MAX_BRIDGE_TOPIC                8           // 经事件桥转发的主题的数量
+    #define EOS_USE_BRIDGE_STREAM               1           // 经字节流（串口、管道等）转发
+    #define EOS_SIZE_BRIDGE_FRAME               512         // 字节流中一帧的最大字节数
+#endif
 
 /* Error -------------------------------------------------------------------- */
 #if ((EOS_MCU_TYPE != 8) && (EOS_MCU_TYPE != 16) && (EOS_MCU_TYPE != 32))
@@ -76,20 +152,89 @@
 #error The test paltform must be 32-bit or 64-bit !
 #endif
 
-#if (EOS_MAX_ACTOR > EOS_MCU_TYPE || EOS_MAX_ACTORS <= 0)
-#error The maximum number of actors must be 1 ~ EOS_MCU_TYPE !
+#if (EOS_MAX_ACTORS > 64 || EOS_MAX_ACTORS <= 0)
+#error The maximum number of actors must be 1 ~ 64 !
+#endif
+
+#if (EOS_SIZE_DISPATCH_BATCH > 255 || EOS_SIZE_DISPATCH_BATCH <= 0)
+#error The dispatch batch size must be 1 ~ 255 !
+#endif
+
+#if (EOS_USE_MULTI_WORKER != 0)
+    #if (EOS_MAX_WORKERS > EOS_MAX_ACTORS || EOS_MAX_WORKERS <= 0)
+        #error The maximum number of workers must be 1 ~ EOS_MAX_ACTORS !
+    #endif
+#endif
+
+#if (EOS_USE_WORK_STEALING != 0 && EOS_USE_MULTI_WORKER == 0)
+    #error The work stealing needs the multi-worker scheduler !
 #endif
 
 #if (EOS_USE_SM_MODE != 0)
     #if (EOS_USE_HSM_MODE != 0)
-        #if (EOS_MAX_HSM_NEST_DEPTH > 4 || EOS_MAX_HSM_NEST_DEPTH < 2)
-            #error The maximum nested depth of hsm must be 2 ~ 4 !
+        #if (EOS_USE_HSM_CACHE == 0 && (EOS_MAX_HSM_NEST_DEPTH > 16 || EOS_MAX_HSM_NEST_DEPTH < 2))
+            #error The maximum nested depth of hsm must be 2 ~ 16 without the hsm cache !
         #endif
+        #if (EOS_USE_HSM_CACHE != 0 && (EOS_MAX_HSM_NEST_DEPTH > 255 || EOS_MAX_HSM_NEST_DEPTH < 2))
+            #error The maximum nested depth of hsm must be 2 ~ 255 !
+        #endif
+    #endif
+#endif
+
+#if (EOS_USE_HSM_CACHE != 0)
+    #if (EOS_USE_SM_MODE == 0 || EOS_USE_HSM_MODE == 0)
+        #error The hsm cache needs the hsm mode !
+    #endif
+    #if (EOS_MAX_HSM_STATES < 8 || EOS_MAX_HSM_STATES > 4096 || \
+         (EOS_MAX_HSM_STATES & (EOS_MAX_HSM_STATES - 1)) != 0)
+        #error The number of cached hsm states must be a power of 2 in 8 ~ 4096 !
+    #endif
+#endif
+
+#if (EOS_USE_HSM_TRAN_CACHE != 0)
+    #if (EOS_USE_HSM_CACHE == 0)
+        #error The hsm transition cache needs the hsm cache !
+    #endif
+    #if (EOS_SIZE_HSM_TRAN_CACHE < 1 || EOS_SIZE_HSM_TRAN_CACHE > 255)
+        #error The number of cached hsm transitions must be 1 ~ 255 !
+    #endif
+    #if (EOS_SIZE_HSM_TRAN_PATH < 1 || EOS_SIZE_HSM_TRAN_PATH > 16 || \
+         EOS_SIZE_HSM_TRAN_PATH > EOS_MAX_HSM_NEST_DEPTH)
+        #error The cached hsm transition path must be 1 ~ 16 and no deeper than the hsm !
+    #endif
+#endif
+
+#if (EOS_USE_HSM_HISTORY != 0)
+    #if (EOS_USE_HSM_CACHE == 0)
+        #error The hsm history needs the hsm cache !
+    #endif
+    #if (EOS_MAX_HSM_HISTORY < 1 || EOS_MAX_HSM_HISTORY > 255)
+        #error The number of hsm states with history must be 1 ~ 255 !
     #endif
 #endif
 
-#if (EOS_USE_TIME_EVENT != 0 && EOS_MAX_TIME_EVENT >= 256)
-    #error The number of time events must be less than 256 !
+#if (EOS_USE_TIME_EVENT != 0)
+    #if (EOS_USE_TIMER_MIN_HEAP == 0 && EOS_MAX_TIME_EVENT >= 256)
+        #error The number of time events must be less than 256 !
+    #endif
+    #if (EOS_USE_TIMER_MIN_HEAP != 0 && EOS_MAX_TIME_EVENT > 8192)
+        #error The number of time events must be 1 ~ 8192 if the min-heap is used !
+    #endif
+    #if (EOS_MAX_UNBLOCKED_TOPIC < 1 || EOS_MAX_UNBLOCKED_TOPIC > 255)
+        #error The number of unblocked topics must be 1 ~ 255 !
+    #endif
+#endif
+
+#if (EOS_SIZE_TOPIC_QUEUE < 2 || EOS_SIZE_TOPIC_QUEUE > 4096 || \
+     (EOS_SIZE_TOPIC_QUEUE & (EOS_SIZE_TOPIC_QUEUE - 1)) != 0)
+    #error The size of the topic queue must be a power of 2 in 2 ~ 4096 !
+#endif
+
+#if (EOS_USE_PUB_INGRESS != 0)
+    #if (EOS_SIZE_PUB_INGRESS < 2 || EOS_SIZE_PUB_INGRESS > 4096 || \
+         (EOS_SIZE_PUB_INGRESS & (EOS_SIZE_PUB_INGRESS - 1)) != 0)
+        #error The size of the ingress ring must be a power of 2 in 2 ~ 4096 !
+    #endif
 #endif
 
 #if (EOS_USE_EVENT_DATA != 0)
@@ -98,4 +243,16 @@
     #endif
 #endif
 
+#if (EOS_USE_EVENT_BRIDGE != 0)
+    #if (EOS_SIZE_BRIDGE < 64 || (EOS_SIZE_BRIDGE & (EOS_SIZE_BRIDGE - 1)) != 0)
+        #error The size of the bridge ring must be a power of 2 and not less than 64 !
+    #endif
+    #if (EOS_MAX_BRIDGE_TOPIC < 1 || EOS_MAX_BRIDGE_TOPIC > 255)
+        #error The number of bridged topics must be 1 ~ 255 !
+    #endif
+    #if (EOS_USE_BRIDGE_STREAM != 0 && (EOS_SIZE_BRIDGE_FRAME < 32 || EOS_SIZE_BRIDGE_FRAME > 65535))
+        #error The size of the bridge frame must be 32 ~ 65535 !
+    #endif
+#endif
+
 #endif
@@ -67,12 +67,15 @@ typedef eos_u16_t                       eos_mcu_t;
 typedef eos_u32_t                       eos_mcu_t;
 #endif
 
-#if (EOS_MCU_TYPE == 8)
-typedef eos_u8_t                        eos_sub_t;
-#elif (EOS_MCU_TYPE == 16)
+// 订阅掩码，每个Actor占一位，Actor数量超过MCU字长时自动加宽
+#if (EOS_MAX_ACTORS > 32)
+typedef unsigned long long              eos_sub_t;
+#elif (EOS_MAX_ACTORS > 16 || EOS_MCU_TYPE == 32)
+typedef eos_u32_t                       eos_sub_t;
+#elif (EOS_MAX_ACTORS > 8 || EOS_MCU_TYPE == 16)
 typedef eos_u16_t                       eos_sub_t;
 #else
-typedef eos_u32_t                       eos_sub_t;
+typedef eos_u8_t                        eos_sub_t;
 #endif
 
 #if (EOS_TEST_PLATFORM == 32)
@@ -1,29 +1,183 @@
 #include "eventos.h"
-#include <sys/time.h>
+#include <pthread.h>
+#include <time.h>
 #include <unistd.h>
 #include <stdlib.h>
 #include <stdio.h>
+#if (EOS_USE_PREEMPT != 0)
+#include <signal.h>
+#include <errno.h>
+#endif
+#if (EOS_USE_EVENT_BRIDGE != 0)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#if (EOS_USE_BRIDGE_STREAM != 0)
+#include <termios.h>
+#endif
+#endif
+
+/* data --------------------------------------------------------------------- */
+#if (EOS_USE_MULTI_WORKER != 0)
+#define EOS_PORT_WORKERS                EOS_MAX_WORKERS
+#else
+#define EOS_PORT_WORKERS                1
+#endif
+
+// 临界区使用递归锁，断言在临界区内触发时会再次进入临界区。
+static pthread_mutex_t eos_mutex;
+// 空闲时主循环阻塞在条件变量上，由发布事件的线程唤醒。
+static pthread_mutex_t eos_idle_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t eos_idle_cond;
+// 每个worker一个唤醒标志，eos_port_wakeup唤醒所有worker
+static eos_bool_t eos_idle_wakeup[EOS_PORT_WORKERS];
+static pthread_once_t eos_port_once = PTHREAD_ONCE_INIT;
+#if (EOS_USE_MULTI_WORKER != 0)
+// 当前线程所运行的worker，eos_run()所在的线程为0
+static __thread eos_u8_t eos_worker_id = 0;
+static pthread_t eos_worker_thread[EOS_MAX_WORKERS];
+#endif
+#if (EOS_USE_PREEMPT != 0)
+// 模拟PendSV：抢占只在eos_run()所在的线程中执行。本线程的请求先记录下来，退出最外层临界区
+// 时执行。其他线程请求的抢占，向该线程发送信号，由信号处理函数打断正在运行的事件处理函数
+// 立即执行，临界区内收到的信号同样推迟到退出临界区时。与MCU上被PendSV打断的代码一样，
+// 事件处理函数调用的库函数需可重入。
+#ifndef EOS_PORT_PREEMPT_SIGNAL
+#define EOS_PORT_PREEMPT_SIGNAL         SIGUSR1
+#endif
+static pthread_t eos_main_thread;
+static volatile eos_bool_t eos_main_started = EOS_False;
+static __thread volatile eos_u32_t eos_critical_nest = 0;
+static eos_bool_t eos_preempt_pending = EOS_False;
+#endif
+
+/* static function ---------------------------------------------------------- */
+static void eos_port_init_once(void)
+{
+    pthread_mutexattr_t mutex_attr;
+    pthread_mutexattr_init(&mutex_attr);
+    pthread_mutexattr_settype(&mutex_attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&eos_mutex, &mutex_attr);
+    pthread_mutexattr_destroy(&mutex_attr);
+
+    // 超时使用单调时钟，不受系统时间调整的影响
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&eos_idle_cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+}
+
+static void eos_port_init(void)
+{
+    pthread_once(&eos_port_once, eos_port_init_once);
+}
+
+#if (EOS_USE_PREEMPT != 0)
+static void eos_port_preempt_run(void)
+{
+    // 信号处理函数可能在此处打断，请求只被取走一次
+    if (eos_main_started == EOS_False ||
+        pthread_equal(pthread_self(), eos_main_thread) == 0 ||
+        __atomic_exchange_n(&eos_preempt_pending, EOS_False, __ATOMIC_ACQ_REL) == EOS_False) {
+        return;
+    }
+    eos_preempt();
+}
+
+// 在eos_run()所在的线程中执行，被打断的代码不在临界区内时立即抢占
+static void eos_port_preempt_signal(int signo)
+{
+    int errno_bkp = errno;
+
+    (void)signo;
+    if (eos_critical_nest == 0) {
+        eos_port_preempt_run();
+    }
+    errno = errno_bkp;
+}
+#endif
+
+// 持有锁期间不执行抢占
+static void eos_port_block(void)
+{
+#if (EOS_USE_PREEMPT != 0)
+    eos_critical_nest ++;
+#endif
+}
 
+static void eos_port_unblock(void)
+{
+#if (EOS_USE_PREEMPT != 0)
+    eos_critical_nest --;
+    if (eos_critical_nest == 0) {
+        eos_port_preempt_run();
+    }
+#endif
+}
+
+#if (EOS_USE_TIME_EVENT != 0)
 static eos_u32_t eos_get_time(void)
 {
-    struct timeval time_crt;
-    gettimeofday(&time_crt, (void *)0);
-    eos_u32_t time_crt_ms = time_crt.tv_sec * 1000 + time_crt.tv_usec / 1000;
+    struct timespec time_crt;
+    clock_gettime(CLOCK_MONOTONIC, &time_crt);
 
-    return time_crt_ms;
+    return (eos_u32_t)(time_crt.tv_sec * 1000 + time_crt.tv_nsec / 1000000);
 }
 
-void eos_port_critical_enter(void)
+// 将休眠期间流逝的时间一次性补偿到框架中
+static eos_bool_t eos_time_started = EOS_False;
+static eos_u32_t eos_time_bkp = 0;
+static void eos_port_time_sync(void)
 {
-    // NULL
+    eos_u32_t system_time = eos_get_time();
+
+    if (eos_time_started == EOS_False) {
+        eos_time_started = EOS_True;
+        eos_time_bkp = system_time;
+        return;
+    }
+
+    eos_port_critical_enter();
+    eos_tick_advance(system_time - eos_time_bkp);
+    eos_port_critical_exit();
+    eos_time_bkp = system_time;
 }
+#endif
 
+/* port --------------------------------------------------------------------- */
+void eos_port_critical_enter(void)
+{
+    eos_port_init();
+    eos_port_block();
+    pthread_mutex_lock(&eos_mutex);
+}
 
 void eos_port_critical_exit(void)
 {
-    // NULL
+    pthread_mutex_unlock(&eos_mutex);
+    eos_port_unblock();
 }
 
+#if (EOS_USE_PREEMPT != 0)
+// 可在任意线程中调用
+void eos_port_preempt(void)
+{
+    __atomic_store_n(&eos_preempt_pending, EOS_True, __ATOMIC_RELEASE);
+    if (eos_main_started == EOS_False) {
+        return;
+    }
+    if (pthread_equal(pthread_self(), eos_main_thread) == 0) {
+        pthread_kill(eos_main_thread, EOS_PORT_PREEMPT_SIGNAL);
+    }
+    else if (eos_critical_nest == 0) {
+        eos_port_preempt_run();
+    }
+}
+#endif
+
 void eos_port_assert(eos_u32_t error_id)
 {
     printf("------------------------------------\n");
@@ -35,33 +189,212 @@ void eos_port_assert(eos_u32_t error_id)
     }
 }
 
-static eos_u32_t eos_time_bkp = 0;
+// 可在任意线程中调用。唤醒标志保证在主循环进入等待之前发布的事件也不会丢失。
+void eos_port_wakeup(void)
+{
+    eos_port_init();
+    eos_port_block();
+    pthread_mutex_lock(&eos_idle_mutex);
+    for (eos_u8_t i = 0; i < EOS_PORT_WORKERS; i ++) {
+        eos_idle_wakeup[i] = EOS_True;
+    }
+    pthread_cond_broadcast(&eos_idle_cond);
+    pthread_mutex_unlock(&eos_idle_mutex);
+    eos_port_unblock();
+}
+
+#if (EOS_USE_EVENT_BRIDGE != 0)
+// 门铃是共享内存中的futex，可以跨进程唤醒
+void eos_port_bridge_notify(eos_bridge_ring_t * const ring)
+{
+    syscall(SYS_futex, &ring->doorbell, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+// 在门铃上等待，门铃响后唤醒本进程的主循环，由调度器一次取出全部事件
+static void * eos_bridge_entry(void *parameter)
+{
+    eos_bridge_ring_t *rx = (eos_bridge_ring_t *)parameter;
+    eos_u32_t doorbell = __atomic_load_n(&rx->doorbell, __ATOMIC_ACQUIRE);
+
+    while (1) {
+        syscall(SYS_futex, &rx->doorbell, FUTEX_WAIT, doorbell, NULL, NULL, 0);
+        eos_u32_t doorbell_new = __atomic_load_n(&rx->doorbell, __ATOMIC_ACQUIRE);
+        if (doorbell_new != doorbell) {
+            doorbell = doorbell_new;
+            eos_port_wakeup();
+        }
+    }
+
+    return NULL;
+}
+
+// 经文件映射的共享内存连接事件桥，两个进程使用同一个路径，side分别为0和1，在eos_init()
+// 之后调用。新建的文件内容全部为0，即为初始化完毕的状态。连接后由应用调用eos_bridge_export()
+// 选择转发的主题。
+eos_bridge_t * eos_port_bridge_open(const char *path, eos_u8_t side)
+{
+    int fd = open(path, O_RDWR | O_CREAT, 0600);
+    if (fd < 0) {
+        return NULL;
+    }
+    // 文件由先打开的进程扩展到所需的大小，重复扩展不改变已有的内容
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        (st.st_size < (off_t)sizeof(eos_bridge_t) &&
+         ftruncate(fd, sizeof(eos_bridge_t)) != 0)) {
+        close(fd);
+        return NULL;
+    }
+    eos_bridge_t *shm = (eos_bridge_t *)mmap(NULL, sizeof(eos_bridge_t),
+                                             PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (shm == MAP_FAILED) {
+        return NULL;
+    }
+
+    eos_bridge_attach(shm, side);
+    pthread_t thread;
+    pthread_create(&thread, NULL, eos_bridge_entry, &shm->ring[1 - side]);
+    pthread_detach(thread);
+
+    return shm;
+}
+
+#if (EOS_USE_BRIDGE_STREAM != 0)
+static int eos_bridge_fd = -1;
+
+void eos_port_bridge_send(eos_u8_t const *data, eos_u32_t size)
+{
+    while (size != 0) {
+        ssize_t ret = write(eos_bridge_fd, data, size);
+        if (ret <= 0) {
+            return;
+        }
+        data += ret;
+        size -= (eos_u32_t)ret;
+    }
+}
+
+// 读到的字节直接交给事件桥，帧校验通过后其中的事件在本地发布，并唤醒主循环
+static void * eos_bridge_stream_entry(void *parameter)
+{
+    eos_u8_t buffer[256];
+    (void)parameter;
+
+    while (1) {
+        ssize_t ret = read(eos_bridge_fd, buffer, sizeof(buffer));
+        if (ret <= 0) {
+            break;
+        }
+        eos_bridge_stream_feed(buffer, (eos_u32_t)ret);
+    }
+
+    return NULL;
+}
+
+// 经串口、pty等字节流连接事件桥，在eos_init()之后调用。终端设备被设为原始模式。转发的主题
+// 同样由eos_bridge_export()选择。
+eos_bool_t eos_port_bridge_stream_open(const char *path)
+{
+    int fd = open(path, O_RDWR | O_NOCTTY);
+    if (fd < 0) {
+        return EOS_False;
+    }
+    struct termios tio;
+    if (isatty(fd) && tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+
+    eos_bridge_fd = fd;
+    eos_bridge_stream_start();
+    pthread_t thread;
+    pthread_create(&thread, NULL, eos_bridge_stream_entry, NULL);
+    pthread_detach(thread);
+
+    return EOS_True;
+}
+#endif
+#endif
+
+/* hook --------------------------------------------------------------------- */
+// 阻塞直到有新事件发布，或者最近的时间事件到期。时间事件只由worker 0处理，其他worker
+// 只等待新事件。
 void eos_hook_idle(void)
 {
+    eos_u32_t wait_ms = EOS_U32_MAX;
+#if (EOS_USE_MULTI_WORKER != 0)
+    eos_u8_t worker = eos_worker_id;
+#else
+    eos_u8_t worker = 0;
+#endif
+
+    eos_port_init();
 #if (EOS_USE_TIME_EVENT != 0)
-    if (eos_time_bkp == 0) {
-        eos_time_bkp = eos_get_time();
-        usleep(1000);
-        return;
+    if (worker == 0) {
+        eos_port_time_sync();
+        wait_ms = eos_time_next();
     }
+#endif
 
-    eos_u32_t system_time = eos_get_time();
+    eos_port_block();
+    pthread_mutex_lock(&eos_idle_mutex);
+    while (eos_idle_wakeup[worker] == EOS_False && wait_ms != 0) {
+        if (wait_ms == EOS_U32_MAX) {
+            pthread_cond_wait(&eos_idle_cond, &eos_idle_mutex);
+            continue;
+        }
 
-    if (system_time >= eos_time_bkp) {
-        for (eos_u32_t i = 0; i < (system_time - eos_time_bkp); i ++) {
-            eos_tick();
+        struct timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += wait_ms / 1000;
+        deadline.tv_nsec += (long)(wait_ms % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec += 1;
+            deadline.tv_nsec -= 1000000000;
         }
-        eos_time_bkp = system_time;
+        pthread_cond_timedwait(&eos_idle_cond, &eos_idle_mutex, &deadline);
+        break;
+    }
+    eos_idle_wakeup[worker] = EOS_False;
+    pthread_mutex_unlock(&eos_idle_mutex);
+    eos_port_unblock();
+
+#if (EOS_USE_TIME_EVENT != 0)
+    if (worker == 0) {
+        eos_port_time_sync();
     }
-    // TODO 此处需要处理时间溢出情况。
 #endif
+}
 
-    usleep(1000);
+#if (EOS_USE_MULTI_WORKER != 0)
+static void * eos_worker_entry(void *parameter)
+{
+    eos_worker_id = (eos_u8_t)(eos_pointer_t)parameter;
+    eos_worker_run(eos_worker_id);
+
+    return NULL;
 }
+#endif
 
+// 为绑定了Actor的worker 1 ~ N - 1各创建一个线程，worker 0运行在eos_run()所在的线程中
 void eos_hook_start(void)
 {
-
+#if (EOS_USE_PREEMPT != 0)
+    struct sigaction action;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    action.sa_handler = eos_port_preempt_signal;
+    sigaction(EOS_PORT_PREEMPT_SIGNAL, &action, NULL);
+    eos_main_thread = pthread_self();
+    eos_main_started = EOS_True;
+#endif
+#if (EOS_USE_MULTI_WORKER != 0)
+    for (eos_u8_t i = 1; i < eos_worker_num(); i ++) {
+        pthread_create(&eos_worker_thread[i], NULL,
+                       eos_worker_entry, (void *)(eos_pointer_t)i);
+    }
+#endif
 }
 
 void eos_hook_stop(void)
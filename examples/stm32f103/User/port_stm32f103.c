@@ -1,5 +1,8 @@
 #include "eventos.h"
 #include "rtt/SEGGER_RTT.h"
+#if (EOS_USE_PREEMPT != 0)
+#include "stm32f10x.h"
+#endif
 
 void eos_port_critical_enter(void)
 {
@@ -25,13 +28,34 @@ void eos_port_assert(eos_u32_t error_id)
     }
 }
 
+void eos_port_wakeup(void)
+{
+    // NULL
+}
+
+#if (EOS_USE_PREEMPT != 0)
+// PendSV优先级最低，在关中断期间或其他中断中挂起时，于开中断、中断返回后才执行
+void eos_port_preempt(void)
+{
+    SCB->ICSR = SCB_ICSR_PENDSVSET;
+}
+
+// 抢占的Actor运行在PendSV中，其间就绪的更高优先级的Actor由eos_preempt()继续分发
+void PendSV_Handler(void)
+{
+    eos_preempt();
+}
+#endif
+
 void eos_hook_idle(void)
 {
 }
 
 void eos_hook_start(void)
 {
-
+#if (EOS_USE_PREEMPT != 0)
+    NVIC_SetPriority(PendSV_IRQn, (1 << __NVIC_PRIO_BITS) - 1);
+#endif
 }
 
 void eos_hook_stop(void)
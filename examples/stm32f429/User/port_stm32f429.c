@@ -20,6 +20,11 @@ void eos_port_assert(eos_u32_t error_id)
     }
 }
 
+void eos_port_wakeup(void)
+{
+    // NULL
+}
+
 void eos_hook_idle(void)
 {
 }
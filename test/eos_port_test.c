@@ -2,6 +2,42 @@
 #include <unistd.h>
 #include "stdio.h"
 #include <stdlib.h>
+#if (EOS_USE_PREEMPT != 0)
+#include <sys/syscall.h>
+#endif
+#if (EOS_USE_MULTI_WORKER != 0)
+#include <pthread.h>
+
+// 多个worker线程并行时，临界区使用递归锁
+static pthread_mutex_t eos_mutex;
+static pthread_once_t eos_port_once = PTHREAD_ONCE_INIT;
+
+static void eos_port_init_once(void)
+{
+    pthread_mutexattr_t mutex_attr;
+    pthread_mutexattr_init(&mutex_attr);
+    pthread_mutexattr_settype(&mutex_attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&eos_mutex, &mutex_attr);
+    pthread_mutexattr_destroy(&mutex_attr);
+}
+#endif
+
+#if (EOS_USE_PREEMPT != 0)
+// 模拟PendSV：抢占只在调度线程中执行。临界区内或其他线程请求的抢占，在调度线程退出最外层
+// 临界区时执行。单元测试在主线程中调度，其他线程只是事件的生产者。
+static __thread eos_u32_t eos_critical_nest = 0;
+static eos_bool_t eos_preempt_pending = EOS_False;
+
+static void eos_port_preempt_run(void)
+{
+    if (__atomic_load_n(&eos_preempt_pending, __ATOMIC_ACQUIRE) == EOS_False ||
+        getpid() != (pid_t)syscall(SYS_gettid)) {
+        return;
+    }
+    __atomic_store_n(&eos_preempt_pending, EOS_False, __ATOMIC_RELEASE);
+    eos_preempt();
+}
+#endif
 
 void set_time_ms(eos_u32_t time_ms)
 {
@@ -10,29 +46,78 @@ void set_time_ms(eos_u32_t time_ms)
     eos_u32_t time_ms_count = eos_time();
 
     if (time_ms >= time_ms_count) {
-        for (eos_u32_t i = 0; i < (time_ms - time_ms_count); i ++)
-            eos_tick();
+        eos_tick_advance(time_ms - time_ms_count);
     }
     else {
-        eos_u32_t count = (EOS_MS_NUM_30DAY + time_ms - time_ms_count);
-        for (eos_u32_t i = 0; i < count; i ++)
-            eos_tick();
+        eos_tick_advance(EOS_MS_NUM_30DAY + time_ms - time_ms_count);
     }
-
-    time_ms_count = time_ms;
 #endif
 }
 
 void eos_port_critical_enter(void)
 {
-    // NULL
+#if (EOS_USE_MULTI_WORKER != 0)
+    pthread_once(&eos_port_once, eos_port_init_once);
+    pthread_mutex_lock(&eos_mutex);
+#endif
+#if (EOS_USE_PREEMPT != 0)
+    eos_critical_nest ++;
+#endif
 }
 
 void eos_port_critical_exit(void)
+{
+#if (EOS_USE_PREEMPT != 0)
+    eos_critical_nest --;
+#endif
+#if (EOS_USE_MULTI_WORKER != 0)
+    pthread_mutex_unlock(&eos_mutex);
+#endif
+#if (EOS_USE_PREEMPT != 0)
+    if (eos_critical_nest == 0) {
+        eos_port_preempt_run();
+    }
+#endif
+}
+
+#if (EOS_USE_PREEMPT != 0)
+void eos_port_preempt(void)
+{
+    __atomic_store_n(&eos_preempt_pending, EOS_True, __ATOMIC_RELEASE);
+    if (eos_critical_nest == 0) {
+        eos_port_preempt_run();
+    }
+}
+#endif
+
+void eos_port_wakeup(void)
 {
     // NULL
 }
 
+#if (EOS_USE_EVENT_BRIDGE != 0)
+// 单元测试中，两端在同一进程内，只记录敲门铃的次数
+eos_u32_t eos_bridge_notify_count = 0;
+
+void eos_port_bridge_notify(eos_bridge_ring_t * const ring)
+{
+    (void)ring;
+    eos_bridge_notify_count ++;
+}
+
+#if (EOS_USE_BRIDGE_STREAM != 0)
+// 发送的帧交给测试用例，未设置时丢弃
+void (* eos_bridge_send_hook)(eos_u8_t const *data, eos_u32_t size) = EOS_NULL;
+
+void eos_port_bridge_send(eos_u8_t const *data, eos_u32_t size)
+{
+    if (eos_bridge_send_hook != EOS_NULL) {
+        eos_bridge_send_hook(data, size);
+    }
+}
+#endif
+#endif
+
 void eos_hook_idle(void)
 {
 
@@ -37,14 +37,52 @@ int reactor_e_tr_count(reactor_t * const me);
 
 /* tool --------------------------------------------------------------------- */
 void set_time_ms(eos_u32_t time_ms);
+// 各测试的公共准备：重新初始化框架，并设置共用的运行时订阅表（topic_max为0时不设置）。
+// 返回框架的数据，用于检查内部状态。
+void * eos_test_setup(eos_topic_t topic_max);
+// 以优先级0 ~ num - 1初始化并启动actor中的各Reactor
+void eos_test_reactors(eos_reactor_t *actor, eos_u8_t num, eos_event_handler handler);
+#if (EOS_USE_SM_MODE != 0)
+// 以优先级0初始化并启动状态机
+void eos_test_sm_start(eos_sm_t * const sm, eos_state_handler state_init);
+#endif
 
 /* test function ------------------------------------------------------------ */
 void eos_test_etimer(void);
+void eos_test_etimer_heap(void);
 void eos_test_event(void);
 void eos_test_heap(void);
+void eos_test_heap_bin(void);
 void eos_test_fsm(void);
+void eos_test_fsm_table(void);
 void eos_test_hsm(void);
+void eos_test_hsm_deep(void);
+void eos_test_hsm_history(void);
 void eos_test_reactor(void);
+void eos_test_priority(void);
+void eos_test_ring(void);
+void eos_test_ref(void);
+void eos_test_ingress(void);
+void eos_test_worker(void);
+void eos_test_preempt(void);
+void eos_test_delay(void);
+void eos_test_bridge(void);
+void eos_test_bridge_stream(void);
 void eos_test_sub(void);
+void eos_test_sub_const(void);
+
+/* benchmark ---------------------------------------------------------------- */
+void eos_bench_dispatch(void);
+void eos_bench_publish(void);
+void eos_bench_heap(void);
+void eos_bench_topic(void);
+void eos_bench_batch(void);
+void eos_bench_timer(void);
+void eos_bench_worker(void);
+void eos_bench_steal(void);
+void eos_bench_stream(void);
+void eos_bench_fsm(void);
+void eos_bench_hsm(void);
+void eos_bench_history(void);
 
 #endif
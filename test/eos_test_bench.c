@@ -0,0 +1,749 @@
+/* include ------------------------------------------------------------------ */
+#include "eos_test.h"
+#include "eventos.h"
+#include "event_def.h"
+#include "unity.h"
+#include "eos_test_def.h"
+#include <stdio.h>
+#include <time.h>
+#if (EOS_USE_MULTI_WORKER != 0)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#if (EOS_USE_BRIDGE_STREAM != 0)
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+/* benchmark data ----------------------------------------------------------- */
+#define EOS_BENCH_TIMES                         256
+
+#if (EOS_USE_PUB_SUB != 0)
+static eos_sub_t sub_table[Event_Max];
+#endif
+static eos_reactor_t bench_low, bench_high;
+static eos_u32_t count_low, count_high;
+
+/* static function ---------------------------------------------------------- */
+static void bench_handler(eos_reactor_t * const me, eos_event_t const * const e)
+{
+    (void)e;
+
+    if (me == &bench_high) {
+        count_high ++;
+    }
+    else {
+        count_low ++;
+    }
+}
+
+static void bench_setup(void)
+{
+    eos_init();
+#if (EOS_USE_PUB_SUB != 0)
+    eos_sub_init(sub_table, Event_Max);
+#endif
+    bench_low.super.enabled = EOS_False;
+    bench_high.super.enabled = EOS_False;
+    eos_reactor_init(&bench_low, 0, EOS_NULL);
+    eos_reactor_start(&bench_low, bench_handler);
+    eos_reactor_init(&bench_high, 1, EOS_NULL);
+    eos_reactor_start(&bench_high, bench_handler);
+#if (EOS_USE_PUB_SUB != 0)
+    eos_event_sub(&bench_low.super, Event_TestReactor);
+    eos_event_sub(&bench_high.super, Event_Test);
+#endif
+    count_low = 0;
+    count_high = 0;
+}
+
+static eos_u32_t bench_ns(struct timespec *start, struct timespec *end)
+{
+    return (eos_u32_t)((end->tv_sec - start->tv_sec) * 1000000000 +
+                       (end->tv_nsec - start->tv_nsec));
+}
+
+/* benchmark ---------------------------------------------------------------- */
+// 低优先级Actor积压backlog个事件时，高优先级Actor的事件分发耗时。
+void eos_bench_dispatch(void)
+{
+#if (EOS_USE_PUB_SUB != 0)
+    eos_u32_t backlog[] = { 0, 64, 256, 1024 };
+    struct timespec start, end;
+
+    for (eos_u32_t n = 0; n < (sizeof(backlog) / sizeof(eos_u32_t)); n ++) {
+        bench_setup();
+        for (eos_u32_t i = 0; i < backlog[n]; i ++) {
+            TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestReactor, EOS_NULL, 0));
+        }
+
+        for (eos_u32_t i = 0; i < EOS_BENCH_TIMES; i ++) {
+            TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
+        }
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (eos_u32_t i = 0; i < EOS_BENCH_TIMES; i ++) {
+            eos_once();
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        TEST_ASSERT_EQUAL_UINT32(EOS_BENCH_TIMES, count_high);
+        TEST_ASSERT_EQUAL_UINT32(0, count_low);
+
+        printf("dispatch, backlog %5u: %6u ns/event.\n",
+               backlog[n], bench_ns(&start, &end) / EOS_BENCH_TIMES);
+
+        // 排空积压的事件
+        while (eos_once() == EosRun_OK);
+        TEST_ASSERT_EQUAL_UINT32(backlog[n], count_low);
+    }
+#endif
+}
+
+// 连续发布count个事件（不分发）时，每次发布的平均耗时。
+void eos_bench_publish(void)
+{
+#if (EOS_USE_PUB_SUB != 0)
+    eos_u32_t count[] = { 64, 256, 1024 };
+    struct timespec start, end;
+
+    for (eos_u32_t n = 0; n < (sizeof(count) / sizeof(eos_u32_t)); n ++) {
+        bench_setup();
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (eos_u32_t i = 0; i < count[n]; i ++) {
+            eos_event_pub_ret(Event_Test, EOS_NULL, 0);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        TEST_ASSERT_EQUAL_UINT32(count[n], ((eos_t *)eos_get_framework())->ring.count + ((eos_t *)eos_get_framework())->heap.count);
+
+        printf("publish, pending %5u: %6u ns/event.\n",
+               count[n], bench_ns(&start, &end) / count[n]);
+
+        while (eos_once() == EosRun_OK);
+        TEST_ASSERT_EQUAL_UINT32(count[n], count_high);
+    }
+#endif
+}
+
+// 混合大小的事件数据，先进先出地申请与释放，对比分级空闲链表打开与关闭时的耗时。
+#define EOS_BENCH_HEAP_DEPTH                    64
+static eos_heap_t bench_heap;
+void eos_heap_init(eos_heap_t * const me);
+void * eos_heap_malloc(eos_heap_t * const me, eos_u32_t size);
+void eos_heap_gc(eos_heap_t * const me, void *data);
+#if (EOS_USE_HEAP_BIN != 0)
+void eos_heap_init_bin(eos_heap_t * const me);
+#endif
+
+static eos_u32_t bench_heap_run(void)
+{
+    static const eos_u32_t size_data[] = { 0, 4, 8, 16, 64, 0, 4, 0, 16, 200 };
+    eos_event_inner_t * fifo[EOS_BENCH_HEAP_DEPTH] = { EOS_NULL };
+    struct timespec start, end;
+    eos_u32_t times = 64 * EOS_BENCH_TIMES;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (eos_u32_t i = 0; i < times; i ++) {
+        eos_u32_t k = i % EOS_BENCH_HEAP_DEPTH;
+        if (fifo[k] != EOS_NULL) {
+            eos_heap_gc(&bench_heap, fifo[k]);
+        }
+        eos_u32_t size = size_data[i % (sizeof(size_data) / sizeof(eos_u32_t))];
+        fifo[k] = eos_heap_malloc(&bench_heap, size + sizeof(eos_event_inner_t));
+        TEST_ASSERT_NOT_NULL(fifo[k]);
+        fifo[k]->sub = 0;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return bench_ns(&start, &end) / times;
+}
+
+void eos_bench_heap(void)
+{
+    eos_heap_init(&bench_heap);
+    printf("heap, first-fit:        %6u ns/malloc+free.\n", bench_heap_run());
+#if (EOS_USE_HEAP_BIN != 0)
+    eos_heap_init_bin(&bench_heap);
+    printf("heap, size-class bins:  %6u ns/malloc+free.\n", bench_heap_run());
+#endif
+}
+
+// 发布并分发一个事件的耗时，对比不携带数据（Ring）与携带4字节数据（Heap）。
+void eos_bench_topic(void)
+{
+#if (EOS_USE_PUB_SUB != 0)
+    struct timespec start, end;
+    eos_u32_t data = 0;
+    eos_u32_t times = 64 * EOS_BENCH_TIMES;
+
+    bench_setup();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (eos_u32_t i = 0; i < times; i ++) {
+        eos_event_pub_ret(Event_Test, EOS_NULL, 0);
+        eos_once();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    TEST_ASSERT_EQUAL_UINT32(times, count_high);
+    printf("topic only, pub + dispatch: %6u ns/event.\n", bench_ns(&start, &end) / times);
+
+    bench_setup();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (eos_u32_t i = 0; i < times; i ++) {
+        eos_event_pub_ret(Event_Test, &data, sizeof(data));
+        eos_once();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    TEST_ASSERT_EQUAL_UINT32(times, count_high);
+    printf("4 bytes,    pub + dispatch: %6u ns/event.\n", bench_ns(&start, &end) / times);
+#endif
+}
+
+// 同一Actor积压事件时，不同的批量分发大小下，每个事件的平均分发耗时。
+void eos_bench_batch(void)
+{
+#if (EOS_USE_PUB_SUB != 0)
+    eos_u8_t batch[] = { 1, 4, 16, 64 };
+    struct timespec start, end;
+    eos_t *f = eos_get_framework();
+
+    for (eos_u32_t n = 0; n < sizeof(batch); n ++) {
+        bench_setup();
+        f->batch = batch[n];
+        for (eos_u32_t i = 0; i < EOS_BENCH_TIMES; i ++) {
+            TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
+        }
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        while (eos_once() == EosRun_OK);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        TEST_ASSERT_EQUAL_UINT32(EOS_BENCH_TIMES, count_high);
+
+        printf("batch %3u: %6u ns/event.\n",
+               batch[n], bench_ns(&start, &end) / EOS_BENCH_TIMES);
+    }
+    f->batch = EOS_SIZE_DISPATCH_BATCH;
+#endif
+}
+
+// 定时器池装满时，启动并取消一个定时器的平均耗时。
+void eos_bench_timer(void)
+{
+#if (EOS_USE_TIME_EVENT != 0)
+    struct timespec start, end;
+    eos_u32_t times = 64 * EOS_BENCH_TIMES;
+
+    bench_setup();
+    for (eos_u32_t i = 0; i < (EOS_MAX_TIME_EVENT - 1); i ++) {
+        eos_event_pub_delay((eos_topic_t)(1000 + i), 10000 + i * 3);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (eos_u32_t i = 0; i < times; i ++) {
+        eos_event_pub_delay(999, 5000 + (i % 1000) * 7);
+        eos_event_time_cancel(999);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    TEST_ASSERT_EQUAL_UINT32(EOS_MAX_TIME_EVENT - 1, ((eos_t *)eos_get_framework())->timer_count);
+
+    printf("timer, %4u armed: %6u ns/start+cancel.\n",
+           (eos_u32_t)EOS_MAX_TIME_EVENT, bench_ns(&start, &end) / times);
+#endif
+}
+
+// 各Actor的事件处理耗时为EOS_BENCH_WORK乘以其负载系数。Actor轮流绑定到n个worker线程上，
+// 处理完全部事件的平均耗时。只在多核主机上有加速。
+#if (EOS_USE_MULTI_WORKER != 0 && EOS_USE_PUB_SUB != 0)
+#define EOS_BENCH_WORK                          2000
+
+static eos_reactor_t bench_worker[EOS_MAX_ACTORS];
+static eos_u32_t bench_worker_count[EOS_MAX_ACTORS];
+static eos_u8_t bench_worker_load[EOS_MAX_ACTORS];
+static eos_u32_t bench_worker_done;
+
+static void bench_worker_handler(eos_reactor_t * const me, eos_event_t const * const e)
+{
+    volatile eos_u32_t work = 0;
+    (void)e;
+
+    for (eos_u32_t i = 0; i < EOS_BENCH_WORK * bench_worker_load[me->super.priority]; i ++) {
+        work += i;
+    }
+    bench_worker_count[me->super.priority] ++;
+    __atomic_add_fetch(&bench_worker_done, 1, __ATOMIC_RELEASE);
+}
+
+static void * bench_worker_thread(void *parameter)
+{
+    eos_u8_t worker = (eos_u8_t)(eos_pointer_t)parameter;
+
+    // 事件在启动前已全部发布，全部处理完毕后退出
+    while (__atomic_load_n(&bench_worker_done, __ATOMIC_ACQUIRE) <
+           (EOS_BENCH_TIMES * EOS_MAX_ACTORS)) {
+        if (eos_worker_once(worker) != EosRun_OK) {
+            sched_yield();
+        }
+    }
+
+    return EOS_NULL;
+}
+
+static eos_u32_t bench_worker_run(eos_u8_t n, eos_bool_t steal)
+{
+    pthread_t thread[EOS_MAX_WORKERS];
+    struct timespec start, end;
+
+    eos_init();
+    eos_sub_init(sub_table, Event_Max);
+    for (eos_u8_t i = 0; i < EOS_MAX_ACTORS; i ++) {
+        bench_worker[i].super.enabled = EOS_False;
+        eos_reactor_init(&bench_worker[i], i, EOS_NULL);
+        eos_reactor_start(&bench_worker[i], bench_worker_handler);
+        eos_event_sub(&bench_worker[i].super, Event_Test);
+        eos_worker_bind(&bench_worker[i].super, i % n);
+        bench_worker_count[i] = 0;
+    }
+#if (EOS_USE_WORK_STEALING != 0)
+    if (steal == EOS_True) {
+        eos_worker_steal(n);
+    }
+#else
+    (void)steal;
+#endif
+    TEST_ASSERT_EQUAL_UINT8(n, eos_worker_num());
+    for (eos_u32_t i = 0; i < EOS_BENCH_TIMES; i ++) {
+        TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
+    }
+    bench_worker_done = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (eos_u8_t i = 0; i < n; i ++) {
+        pthread_create(&thread[i], EOS_NULL, bench_worker_thread, (void *)(eos_pointer_t)i);
+    }
+    for (eos_u8_t i = 0; i < n; i ++) {
+        pthread_join(thread[i], EOS_NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    for (eos_u8_t i = 0; i < EOS_MAX_ACTORS; i ++) {
+        TEST_ASSERT_EQUAL_UINT32(EOS_BENCH_TIMES, bench_worker_count[i]);
+    }
+
+    return bench_ns(&start, &end) / (EOS_BENCH_TIMES * EOS_MAX_ACTORS);
+}
+#endif
+
+// 各Actor负载相同时，1 ~ N个worker的耗时。
+void eos_bench_worker(void)
+{
+#if (EOS_USE_MULTI_WORKER != 0 && EOS_USE_PUB_SUB != 0)
+    for (eos_u8_t i = 0; i < EOS_MAX_ACTORS; i ++) {
+        bench_worker_load[i] = 1;
+    }
+    for (eos_u8_t n = 1; n <= EOS_MAX_WORKERS; n ++) {
+        printf("workers %u, %u actors: %8u ns/event.\n",
+               n, (eos_u32_t)EOS_MAX_ACTORS, bench_worker_run(n, EOS_False));
+    }
+#endif
+}
+
+// 负载集中在绑定到worker 0的Actor上时，对比单个worker、静态绑定与工作窃取的耗时。
+void eos_bench_steal(void)
+{
+#if (EOS_USE_WORK_STEALING != 0 && EOS_USE_PUB_SUB != 0)
+    for (eos_u8_t i = 0; i < EOS_MAX_ACTORS; i ++) {
+        bench_worker_load[i] = 1;
+    }
+    for (eos_u8_t i = 0; i < EOS_MAX_ACTORS; i += EOS_MAX_WORKERS) {
+        bench_worker_load[i] = 8;
+    }
+    printf("skewed, 1 worker:              %8u ns/event.\n", bench_worker_run(1, EOS_False));
+    printf("skewed, %u workers, bound:      %8u ns/event.\n",
+           (eos_u32_t)EOS_MAX_WORKERS, bench_worker_run(EOS_MAX_WORKERS, EOS_False));
+    printf("skewed, %u workers, stealing:   %8u ns/event.\n",
+           (eos_u32_t)EOS_MAX_WORKERS, bench_worker_run(EOS_MAX_WORKERS, EOS_True));
+#endif
+}
+
+// 事件经字节流事件桥回环：编码、socketpair、流式解析，再在本地发布并分发。每发布8个事件
+// 发送一次，此时一帧中有8个事件。
+#if (EOS_USE_BRIDGE_STREAM != 0 && EOS_USE_PUB_SUB != 0)
+#define EOS_BENCH_STREAM_BATCH                  8
+
+extern void (* eos_bridge_send_hook)(eos_u8_t const *data, eos_u32_t size);
+static int bench_sock[2];
+
+static void bench_stream_send(eos_u8_t const *data, eos_u32_t size)
+{
+    TEST_ASSERT_EQUAL_INT(size, write(bench_sock[0], data, size));
+}
+#endif
+
+void eos_bench_stream(void)
+{
+#if (EOS_USE_BRIDGE_STREAM != 0 && EOS_USE_PUB_SUB != 0)
+    eos_u32_t size[] = { 0, 16, 64 };
+    eos_u8_t data[64] = { 0 };
+    eos_u8_t buffer[2 * EOS_SIZE_BRIDGE_FRAME];
+    struct timespec start, end;
+    eos_u32_t bytes;
+
+    TEST_ASSERT_EQUAL_INT(0, socketpair(AF_UNIX, SOCK_STREAM, 0, bench_sock));
+    eos_bridge_send_hook = bench_stream_send;
+    for (eos_u32_t n = 0; n < (sizeof(size) / sizeof(eos_u32_t)); n ++) {
+        bench_setup();
+        eos_bridge_export(Event_Test);
+        eos_bridge_stream_start();
+        bytes = 0;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (eos_u32_t i = 0; i < EOS_BENCH_TIMES; i += EOS_BENCH_STREAM_BATCH) {
+            for (eos_u32_t j = 0; j < EOS_BENCH_STREAM_BATCH; j ++) {
+                eos_event_pub_ret(Event_Test, data, size[n]);
+            }
+            eos_bridge_flush();
+            ssize_t len = recv(bench_sock[1], buffer, sizeof(buffer), MSG_DONTWAIT);
+            TEST_ASSERT(len > 0);
+            eos_bridge_stream_feed(buffer, (eos_u32_t)len);
+            bytes += (eos_u32_t)len;
+            while (eos_once() == EosRun_OK);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        // 本地发布与对端发来的各一次
+        TEST_ASSERT_EQUAL_UINT32(2 * EOS_BENCH_TIMES, count_high);
+
+        printf("stream, data %3u bytes: %6u ns/event, %3u bytes/event on the wire.\n",
+               size[n], bench_ns(&start, &end) / EOS_BENCH_TIMES, bytes / EOS_BENCH_TIMES);
+    }
+    eos_bridge_send_hook = EOS_NULL;
+    close(bench_sock[0]);
+    close(bench_sock[1]);
+#endif
+}
+
+// 两个状态的平面状态机，每个事件转换一次状态。对比状态函数（eos_fsm.c）与转换表的分发耗时。
+#if (EOS_USE_FSM_TABLE != 0 && EOS_USE_PUB_SUB != 0)
+enum {
+    BenchState_Off = 0,
+    BenchState_On,
+
+    BenchState_Max
+};
+
+typedef struct bench_fsm {
+    eos_fsm_t super;
+    eos_u32_t status;
+    eos_u32_t count;
+} bench_fsm_t;
+
+static bench_fsm_t bench_table_fsm;
+
+static void bench_fsm_count(bench_fsm_t * const me, eos_event_t const * const e)
+{
+    (void)e;
+    me->count ++;
+}
+
+static void bench_fsm_enter(bench_fsm_t * const me, eos_event_t const * const e)
+{
+    (void)e;
+    me->status = me->super.state;
+}
+
+static const eos_fsm_tran_t bench_fsm_tran[BenchState_Max][Event_Max - Event_User] = {
+    EOS_FSM_ROW(BenchState_Off,
+        EOS_FSM_ON(Event_TestFsm, bench_fsm_count, BenchState_On)),
+    EOS_FSM_ROW(BenchState_On,
+        EOS_FSM_ON(Event_TestFsm, bench_fsm_count, BenchState_Off)),
+};
+
+static const eos_fsm_state_t bench_fsm_state[BenchState_Max] = {
+    { EOS_FSM_ACTION_CAST(bench_fsm_enter), EOS_NULL },
+    { EOS_FSM_ACTION_CAST(bench_fsm_enter), EOS_NULL },
+};
+
+static const eos_fsm_table_t bench_fsm_table =
+    EOS_FSM_TABLE(bench_fsm_tran, bench_fsm_state, BenchState_Max, Event_Max);
+
+static eos_u32_t bench_fsm_run(void)
+{
+    struct timespec start, end;
+
+    for (eos_u32_t i = 0; i < EOS_BENCH_TIMES; i ++) {
+        TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestFsm, EOS_NULL, 0));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while (eos_once() == EosRun_OK);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return bench_ns(&start, &end) / EOS_BENCH_TIMES;
+}
+#endif
+
+void eos_bench_fsm(void)
+{
+#if (EOS_USE_FSM_TABLE != 0 && EOS_USE_PUB_SUB != 0)
+    static fsm_t bench_handler_fsm;
+
+    eos_init();
+    eos_sub_init(sub_table, Event_Max);
+    bench_handler_fsm.super.super.enabled = EOS_False;
+    fsm_init(&bench_handler_fsm, 0, EOS_NULL);
+    printf("fsm, state handler: %6u ns/event.\n", bench_fsm_run());
+    TEST_ASSERT_EQUAL_UINT32(EOS_BENCH_TIMES, fsm_event_count(&bench_handler_fsm));
+
+    eos_init();
+    eos_sub_init(sub_table, Event_Max);
+    bench_table_fsm.super.super.super.enabled = EOS_False;
+    bench_table_fsm.count = 0;
+    eos_fsm_init(&bench_table_fsm.super, 0, &bench_fsm_table);
+    eos_fsm_start(&bench_table_fsm.super, BenchState_Off);
+    eos_event_sub(&bench_table_fsm.super.super.super, Event_TestFsm);
+    printf("fsm, table:         %6u ns/event.\n", bench_fsm_run());
+    TEST_ASSERT_EQUAL_UINT32(EOS_BENCH_TIMES, bench_table_fsm.count);
+#endif
+}
+
+// 两个分支各4层的层次状态机，每个事件在两个最深的叶子状态之间转换一次，退出与进入各3层。
+// 同时统计每次转换调用状态函数的次数，打开EOS_USE_HSM_CACHE后不再调用状态函数探测父状态。
+#if (EOS_USE_HSM_MODE != 0 && EOS_USE_PUB_SUB != 0)
+typedef struct bench_hsm {
+    eos_sm_t super;
+    eos_u32_t count;
+} bench_hsm_t;
+
+static bench_hsm_t bench_hsm;
+
+static eos_ret_t bench_hsm_a4(bench_hsm_t * const me, eos_event_t const * const e);
+static eos_ret_t bench_hsm_b4(bench_hsm_t * const me, eos_event_t const * const e);
+
+static eos_ret_t bench_hsm_init(bench_hsm_t * const me, eos_event_t const * const e)
+{
+    (void)e;
+    EOS_EVENT_SUB(Event_TestHsm);
+
+    return EOS_TRAN(bench_hsm_a4);
+}
+
+static eos_ret_t bench_hsm_1(bench_hsm_t * const me, eos_event_t const * const e)
+{
+    (void)e;
+    me->count ++;
+
+    return EOS_SUPER(eos_state_top);
+}
+
+static eos_ret_t bench_hsm_a2(bench_hsm_t * const me, eos_event_t const * const e)
+{
+    (void)e;
+    me->count ++;
+
+    return EOS_SUPER(bench_hsm_1);
+}
+
+static eos_ret_t bench_hsm_a3(bench_hsm_t * const me, eos_event_t const * const e)
+{
+    (void)e;
+    me->count ++;
+
+    return EOS_SUPER(bench_hsm_a2);
+}
+
+static eos_ret_t bench_hsm_a4(bench_hsm_t * const me, eos_event_t const * const e)
+{
+    me->count ++;
+    if (e->topic == Event_TestHsm) {
+        return EOS_TRAN(bench_hsm_b4);
+    }
+
+    return EOS_SUPER(bench_hsm_a3);
+}
+
+static eos_ret_t bench_hsm_b2(bench_hsm_t * const me, eos_event_t const * const e)
+{
+    (void)e;
+    me->count ++;
+
+    return EOS_SUPER(bench_hsm_1);
+}
+
+static eos_ret_t bench_hsm_b3(bench_hsm_t * const me, eos_event_t const * const e)
+{
+    (void)e;
+    me->count ++;
+
+    return EOS_SUPER(bench_hsm_b2);
+}
+
+static eos_ret_t bench_hsm_b4(bench_hsm_t * const me, eos_event_t const * const e)
+{
+    me->count ++;
+    if (e->topic == Event_TestHsm) {
+        return EOS_TRAN(bench_hsm_a4);
+    }
+
+    return EOS_SUPER(bench_hsm_b3);
+}
+#endif
+
+void eos_bench_hsm(void)
+{
+#if (EOS_USE_HSM_MODE != 0 && EOS_USE_PUB_SUB != 0)
+    struct timespec start, end;
+
+    eos_init();
+    eos_sub_init(sub_table, Event_Max);
+    bench_hsm.super.super.enabled = EOS_False;
+    eos_sm_init(&bench_hsm.super, 0, EOS_NULL);
+    eos_sm_start(&bench_hsm.super, EOS_STATE_CAST(bench_hsm_init));
+    // 预热一次往返，使两个分支的状态都被探测过
+    for (eos_u32_t i = 0; i < 2; i ++) {
+        TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestHsm, EOS_NULL, 0));
+    }
+    while (eos_once() == EosRun_OK);
+
+    bench_hsm.count = 0;
+    for (eos_u32_t i = 0; i < EOS_BENCH_TIMES; i ++) {
+        TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestHsm, EOS_NULL, 0));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while (eos_once() == EosRun_OK);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    TEST_ASSERT(bench_hsm.super.state == EOS_STATE_CAST(bench_hsm_a4));
+    printf("hsm, deep transition: %6u ns/event, %2u state calls/event.\n",
+           bench_ns(&start, &end) / EOS_BENCH_TIMES, bench_hsm.count / EOS_BENCH_TIMES);
+
+#if (EOS_USE_HSM_TRAN_CACHE != 0)
+    // 每个事件前清空转换缓存，对比每次由状态拓扑计算路径的耗时
+    eos_u32_t ns_hit = 0, ns_miss = 0;
+    for (eos_u32_t i = 0; i < EOS_BENCH_TIMES; i ++) {
+        for (eos_u32_t miss = 0; miss < 2; miss ++) {
+            TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestHsm, EOS_NULL, 0));
+            bench_hsm.super.tran_count = (miss != 0) ? 0 : bench_hsm.super.tran_count;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            if (miss != 0) {
+                ns_miss += bench_ns(&start, &end);
+            }
+            else {
+                ns_hit += bench_ns(&start, &end);
+            }
+        }
+    }
+    printf("hsm, transition cache: %6u ns/event hit, %6u ns/event miss.\n",
+           ns_hit / EOS_BENCH_TIMES, ns_miss / EOS_BENCH_TIMES);
+#endif
+#endif
+}
+
+// 空闲状态与4层的模式之间往返，模式的各层都有初始转换。对比每次由初始转换逐层钻入，与转换
+// 到深历史直接进入叶状态时，一次往返的耗时与调用状态函数的次数。
+#if (EOS_USE_HSM_HISTORY != 0 && EOS_USE_PUB_SUB != 0)
+typedef struct bench_hist {
+    eos_sm_t super;
+    eos_u32_t count;
+    eos_bool_t history;
+} bench_hist_t;
+
+static bench_hist_t bench_hist;
+
+static eos_ret_t bench_hist_idle(bench_hist_t * const me, eos_event_t const * const e);
+static eos_ret_t bench_hist_1(bench_hist_t * const me, eos_event_t const * const e);
+static eos_ret_t bench_hist_2(bench_hist_t * const me, eos_event_t const * const e);
+static eos_ret_t bench_hist_3(bench_hist_t * const me, eos_event_t const * const e);
+static eos_ret_t bench_hist_4(bench_hist_t * const me, eos_event_t const * const e);
+
+static eos_ret_t bench_hist_init(bench_hist_t * const me, eos_event_t const * const e)
+{
+    (void)e;
+    EOS_EVENT_SUB(Event_TestHsm);
+    EOS_HISTORY(bench_hist_1);
+
+    return EOS_TRAN(bench_hist_idle);
+}
+
+static eos_ret_t bench_hist_idle(bench_hist_t * const me, eos_event_t const * const e)
+{
+    me->count ++;
+    if (e->topic == Event_TestHsm) {
+        return (me->history == EOS_False) ?
+                EOS_TRAN(bench_hist_1) : EOS_TRAN_DEEP_HISTORY(bench_hist_1);
+    }
+
+    return EOS_SUPER(eos_state_top);
+}
+
+static eos_ret_t bench_hist_1(bench_hist_t * const me, eos_event_t const * const e)
+{
+    me->count ++;
+    if (e->topic == Event_Init) {
+        return EOS_TRAN(bench_hist_2);
+    }
+
+    return EOS_SUPER(eos_state_top);
+}
+
+static eos_ret_t bench_hist_2(bench_hist_t * const me, eos_event_t const * const e)
+{
+    me->count ++;
+    if (e->topic == Event_Init) {
+        return EOS_TRAN(bench_hist_3);
+    }
+
+    return EOS_SUPER(bench_hist_1);
+}
+
+static eos_ret_t bench_hist_3(bench_hist_t * const me, eos_event_t const * const e)
+{
+    me->count ++;
+    if (e->topic == Event_Init) {
+        return EOS_TRAN(bench_hist_4);
+    }
+
+    return EOS_SUPER(bench_hist_2);
+}
+
+static eos_ret_t bench_hist_4(bench_hist_t * const me, eos_event_t const * const e)
+{
+    me->count ++;
+    if (e->topic == Event_TestHsm) {
+        return EOS_TRAN(bench_hist_idle);
+    }
+
+    return EOS_SUPER(bench_hist_3);
+}
+
+// 往返EOS_BENCH_TIMES次，返回每次往返的耗时
+static eos_u32_t bench_hist_run(eos_bool_t history)
+{
+    struct timespec start, end;
+
+    bench_hist.history = history;
+    bench_hist.count = 0;
+    for (eos_u32_t i = 0; i < 2 * EOS_BENCH_TIMES; i ++) {
+        TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestHsm, EOS_NULL, 0));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while (eos_once() == EosRun_OK);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    TEST_ASSERT(bench_hist.super.state == EOS_STATE_CAST(bench_hist_idle));
+
+    return bench_ns(&start, &end) / EOS_BENCH_TIMES;
+}
+#endif
+
+void eos_bench_history(void)
+{
+#if (EOS_USE_HSM_HISTORY != 0 && EOS_USE_PUB_SUB != 0)
+    eos_init();
+    eos_sub_init(sub_table, Event_Max);
+    bench_hist.super.super.enabled = EOS_False;
+    eos_sm_init(&bench_hist.super, 0, EOS_NULL);
+    eos_sm_start(&bench_hist.super, EOS_STATE_CAST(bench_hist_init));
+    // 预热一次往返，使各状态都被缓存，并记下历史
+    (void)bench_hist_run(EOS_True);
+
+    eos_u32_t ns_init = bench_hist_run(EOS_False);
+    eos_u32_t count_init = bench_hist.count / EOS_BENCH_TIMES;
+    eos_u32_t ns_history = bench_hist_run(EOS_True);
+    eos_u32_t count_history = bench_hist.count / EOS_BENCH_TIMES;
+    printf("hsm, resume by init:    %6u ns/round, %2u state calls/round.\n", ns_init, count_init);
+    printf("hsm, resume by history: %6u ns/round, %2u state calls/round.\n",
+           ns_history, count_history);
+#endif
+}
@@ -0,0 +1,173 @@
+/* include ------------------------------------------------------------------ */
+#include "eos_test.h"
+#include "eventos.h"
+#include "event_def.h"
+#include "unity.h"
+#include "eos_test_def.h"
+
+#if (EOS_USE_EVENT_BRIDGE != 0)
+/* bridge function ---------------------------------------------------------- */
+eos_bridge_record_t * eos_bridge_peek(eos_bridge_ring_t * const me);
+void eos_bridge_take(eos_bridge_ring_t * const me, eos_bridge_record_t * const record);
+
+extern eos_u32_t eos_bridge_notify_count;
+
+/* unittest ----------------------------------------------------------------- */
+static eos_bridge_t bridge;
+static eos_reactor_t bridge_actor[1];
+static eos_topic_t log_topic[8];
+static eos_u32_t log_size[8];
+static eos_u8_t log_data[8];
+static eos_u32_t log_count;
+static eos_t *f;
+
+static void bridge_handler(eos_reactor_t * const me, eos_event_t const * const e)
+{
+    (void)me;
+
+    if (log_count < 8) {
+        log_topic[log_count] = e->topic;
+        log_size[log_count] = e->size;
+        log_data[log_count] = (e->size != 0) ? ((eos_u8_t *)e->data)[e->size - 1] : 0;
+    }
+    log_count ++;
+}
+
+static void bridge_check_record(eos_bridge_ring_t * const ring,
+                                eos_topic_t topic, eos_u32_t size, eos_u8_t last)
+{
+    eos_bridge_record_t *record = eos_bridge_peek(ring);
+    TEST_ASSERT_NOT_NULL(record);
+    TEST_ASSERT_EQUAL_UINT16(topic, record->topic);
+    TEST_ASSERT_EQUAL_UINT16(size, record->size);
+    if (size != 0) {
+        TEST_ASSERT_EQUAL_UINT8(last, ((eos_u8_t *)(record + 1))[size - 1]);
+    }
+    eos_bridge_take(ring, record);
+}
+
+// 模拟对端进程，在接收方向的缓冲区中写入一条记录，记录不跨越尾部
+static void bridge_peer_write(eos_bridge_ring_t * const ring,
+                              eos_topic_t topic, void const *data, eos_u32_t size)
+{
+    eos_u32_t offset = ring->head & (EOS_SIZE_BRIDGE - 1);
+    eos_bridge_record_t *record = (eos_bridge_record_t *)((eos_u8_t *)ring->data + offset);
+    record->topic = topic;
+    record->size = (eos_u16_t)size;
+    for (eos_u32_t i = 0; i < size; i ++) {
+        ((eos_u8_t *)(record + 1))[i] = ((eos_u8_t const *)data)[i];
+    }
+    ring->head += sizeof(eos_bridge_record_t) + ((size + 3) & ~3);
+}
+#endif
+
+void eos_test_bridge(void)
+{
+#if (EOS_USE_EVENT_BRIDGE != 0)
+    eos_u8_t data[EOS_SIZE_BRIDGE];
+    for (eos_u32_t i = 0; i < EOS_SIZE_BRIDGE; i ++) {
+        data[i] = (eos_u8_t)i;
+    }
+
+    // 环形缓冲区，记录连续存放，尾部不足时跳到开头 --------------------------------
+    // 本实例中没有订阅者，发布的事件只写入发送方向的缓冲区
+    f = eos_test_setup(Event_Max);
+    eos_test_reactors(bridge_actor, 1, bridge_handler);
+    eos_bridge_shm_init(&bridge);
+    eos_bridge_attach(&bridge, 0);
+    eos_bridge_export(Event_Test);
+    eos_bridge_export(Event_TestFsm);
+    eos_bridge_ring_t *ring = &bridge.ring[0];
+    eos_bridge_notify_count = 0;
+    TEST_ASSERT_NULL(eos_bridge_peek(ring));
+    // 接收方取空之后，每批事件只敲一次门铃
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, data, 5));
+    TEST_ASSERT_EQUAL_UINT32(1, eos_bridge_notify_count);
+    TEST_ASSERT_EQUAL_UINT32(1, ring->doorbell);
+    TEST_ASSERT_EQUAL_UINT32(4 + 4 + 8, ring->head);
+    bridge_check_record(ring, Event_Test, 0, 0);
+    bridge_check_record(ring, Event_Test, 5, 4);
+    TEST_ASSERT_NULL(eos_bridge_peek(ring));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestFsm, data, 1));
+    TEST_ASSERT_EQUAL_UINT32(2, eos_bridge_notify_count);
+    bridge_check_record(ring, Event_TestFsm, 1, 0);
+
+    // 缓冲区已满时丢弃，计入lost
+    eos_u32_t size_half = EOS_SIZE_BRIDGE / 2 - 4;
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, data, size_half));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, data, size_half));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, data, EOS_SIZE_BRIDGE));
+    TEST_ASSERT_EQUAL_UINT32(2, ring->lost);
+    bridge_check_record(ring, Event_Test, size_half, (eos_u8_t)(size_half - 1));
+    // 尾部空间不足，填充后从开头写入
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, data, size_half));
+    TEST_ASSERT_EQUAL_UINT32(EOS_SIZE_BRIDGE + 4 + size_half, ring->head);
+    bridge_check_record(ring, Event_Test, size_half, (eos_u8_t)(size_half - 1));
+    TEST_ASSERT_EQUAL_UINT32(ring->head, ring->tail);
+    TEST_ASSERT_NULL(eos_bridge_peek(ring));
+
+    // 转发与接收 ---------------------------------------------------------------
+    f = eos_test_setup(Event_Max);
+    eos_test_reactors(bridge_actor, 1, bridge_handler);
+#if (EOS_USE_PUB_SUB != 0)
+    eos_event_sub(&bridge_actor[0].super, Event_Test);
+    eos_event_sub(&bridge_actor[0].super, Event_TestFsm);
+#endif
+    log_count = 0;
+    eos_bridge_shm_init(&bridge);
+    eos_bridge_attach(&bridge, 0);
+    eos_bridge_export(Event_Test);
+    eos_bridge_export(Event_TestHsm);
+    eos_bridge_export(Event_Test);
+    TEST_ASSERT_EQUAL_UINT8(2, f->bridge_count);
+
+    // 转发的主题同时在本地发布，只有对端订阅的主题不是错误
+    eos_event_pub_topic(Event_Test);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestHsm, EOS_NULL, 0));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestFsm, EOS_NULL, 0));
+#if (EOS_USE_EVENT_DATA != 0)
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, data, 10));
+    eos_u8_t *e_data = eos_event_alloc(Event_Test, 3);
+    TEST_ASSERT_NOT_NULL(e_data);
+    e_data[2] = 0x5a;
+    eos_event_commit(e_data);
+#endif
+    while (eos_once() == EosRun_OK);
+    // 经入口环发布的事件，在下一次直接发布前转发，保持发布顺序
+    bridge_check_record(&bridge.ring[0], Event_Test, 0, 0);
+    bridge_check_record(&bridge.ring[0], Event_TestHsm, 0, 0);
+#if (EOS_USE_EVENT_DATA != 0)
+    bridge_check_record(&bridge.ring[0], Event_Test, 10, 9);
+    bridge_check_record(&bridge.ring[0], Event_Test, 3, 0x5a);
+#endif
+#if (EOS_USE_EVENT_DATA != 0)
+    TEST_ASSERT_EQUAL_UINT32(4, log_count);
+#else
+    TEST_ASSERT_EQUAL_UINT32(2, log_count);
+#endif
+    TEST_ASSERT_NULL(eos_bridge_peek(&bridge.ring[0]));
+
+    // 对端发来的事件，在调度时发布，不再转发回去
+    log_count = 0;
+    bridge_peer_write(&bridge.ring[1], Event_Test, EOS_NULL, 0);
+    bridge_peer_write(&bridge.ring[1], Event_TestReactor, EOS_NULL, 0);
+    bridge_peer_write(&bridge.ring[1], Event_Max, EOS_NULL, 0);
+#if (EOS_USE_EVENT_DATA != 0)
+    bridge_peer_write(&bridge.ring[1], Event_TestFsm, data, 7);
+#endif
+    TEST_ASSERT_EQUAL_UINT32(0, log_count);
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_NULL(eos_bridge_peek(&bridge.ring[1]));
+    TEST_ASSERT_NULL(eos_bridge_peek(&bridge.ring[0]));
+    TEST_ASSERT_EQUAL_UINT16(Event_Test, log_topic[0]);
+#if (EOS_USE_EVENT_DATA != 0)
+    TEST_ASSERT_EQUAL_UINT32(2, log_count);
+    TEST_ASSERT_EQUAL_UINT16(Event_TestFsm, log_topic[1]);
+    TEST_ASSERT_EQUAL_UINT32(7, log_size[1]);
+    TEST_ASSERT_EQUAL_UINT8(6, log_data[1]);
+#else
+    TEST_ASSERT_EQUAL_UINT32(1, log_count);
+#endif
+#endif
+}
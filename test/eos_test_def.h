@@ -25,6 +25,61 @@ enum {
     EosRunErr_TimerRepeated                 = -7,
 };
 
+#define EOS_MAGIC_NUMBER                    0xDEADBEEF
+
+#define EOS_SUB_BIT(priority_)              ((eos_sub_t)1 << (priority_))
+#define EOS_SUB_ALL                         ((eos_sub_t)(~(eos_sub_t)0))
+
+// 主题的订阅者，由编译期的订阅表与运行时的订阅表叠加而成
+#if (EOS_USE_PUB_SUB != 0 && EOS_USE_SUB_CONST != 0)
+#define EOS_SUB_NONE()                      (eos.sub_table == EOS_NULL && eos.sub_const == EOS_NULL)
+#define EOS_SUB_READ(topic_)                (eos_sub_read(topic_))
+#elif (EOS_USE_PUB_SUB != 0)
+#define EOS_SUB_NONE()                      (eos.sub_table == EOS_NULL)
+#define EOS_SUB_READ(topic_)                (eos.sub_table[topic_])
+#endif
+
+// 最高优先级的就绪Actor，在32位MCU且使用GCC/Clang时由CLZ指令得到，否则查4位的表。没有
+// CLZ且Actor多于8个时，就绪位图增加一级，每8个Actor对应一位。
+#if (EOS_MCU_TYPE == 32 && defined(__GNUC__))
+#define EOS_USE_CLZ                         1
+#else
+#define EOS_USE_CLZ                         0
+#endif
+#if (EOS_USE_CLZ == 0 && EOS_MAX_ACTORS > 8)
+#define EOS_USE_SUB_GROUP                   1
+#else
+#define EOS_USE_SUB_GROUP                   0
+#endif
+
+// GCC/Clang的16位原子操作无锁时，入口环以CAS占用槽位，层次状态的缓存以原子读写发布，
+// 在Cortex-M3及以上编译为LDREX/STREX。Cortex-M0等ARMv6-M没有LDREX/STREX，原子操作会编
+// 译为需要libatomic的库函数，此时占用槽位在临界区中进行。
+#if (EOS_MCU_TYPE == 32 && defined(__GNUC__) && defined(__GCC_ATOMIC_SHORT_LOCK_FREE) && \
+     (__GCC_ATOMIC_SHORT_LOCK_FREE == 2) && (!defined(__arm__) || __ARM_ARCH >= 7))
+#define EOS_USE_ATOMIC                      1
+#else
+#define EOS_USE_ATOMIC                      0
+#endif
+
+// 多个worker时，定时事件与入口环的取出由各线程共用，由临界区保护，此时临界区必须可重入。
+#if (EOS_USE_MULTI_WORKER != 0)
+#define EOS_WORKER_LOCK()                   eos_port_critical_enter()
+#define EOS_WORKER_UNLOCK()                 eos_port_critical_exit()
+#else
+#define EOS_WORKER_LOCK()                   ((void)0)
+#define EOS_WORKER_UNLOCK()                 ((void)0)
+#endif
+
+// 只有一个worker运行全部Actor时，Actor之间才会抢占。
+#if (EOS_USE_PREEMPT != 0)
+#if (EOS_USE_MULTI_WORKER != 0)
+#define EOS_PREEMPT_ENABLED()               (eos.worker_num == 1)
+#else
+#define EOS_PREEMPT_ENABLED()               (1)
+#endif
+#endif
+
 #if (EOS_USE_TIME_EVENT != 0)
 #define EOS_MS_NUM_30DAY                    (2592000000)
 
@@ -55,6 +110,21 @@ typedef struct eos_event_timer {
     eos_u32_t period                        : 16;
     eos_u32_t timeout_ms;
 } eos_event_timer_t;
+
+#if (EOS_USE_TIMER_MIN_HEAP != 0)
+#define EOS_TIMER_NULL                      0xffff
+#if (EOS_MAX_TIME_EVENT <= 16)
+#define EOS_TIMER_HASH_SIZE                 16
+#elif (EOS_MAX_TIME_EVENT <= 64)
+#define EOS_TIMER_HASH_SIZE                 64
+#elif (EOS_MAX_TIME_EVENT <= 256)
+#define EOS_TIMER_HASH_SIZE                 256
+#elif (EOS_MAX_TIME_EVENT <= 1024)
+#define EOS_TIMER_HASH_SIZE                 1024
+#else
+#define EOS_TIMER_HASH_SIZE                 4096
+#endif
+#endif
 #endif
 
 typedef struct eos_block {
@@ -71,11 +141,78 @@ typedef struct eos_block {
 } eos_block_t;
 
 typedef struct eos_event_inner {
+    eos_u32_t seq;                                      // publish order
     eos_sub_t sub;
     eos_topic_t topic;
+#if (EOS_USE_EVENT_REF != 0)
+    eos_u8_t ref;                                       // holders of the data
+#endif
 } eos_event_inner_t;
 
+// 不携带数据的事件的记录，存放在环中而不是堆中
+typedef struct eos_event_record {
+    eos_u32_t seq;
+    eos_sub_t sub;
+    eos_topic_t topic;
+} eos_event_record_t;
+
+typedef struct eos_ring {
+    eos_event_record_t record[EOS_SIZE_TOPIC_QUEUE];
+    eos_u16_t head;                                     // serial of the oldest record
+    eos_u16_t count;
+    // per-actor serial of the next record to check
+    eos_u16_t cursor[EOS_MAX_ACTORS];
+} eos_ring_t;
+
+#if (EOS_USE_PUB_INGRESS != 0)
+// 无锁的多生产者单消费者主题环，发布者写入，由eos_once取出
+typedef struct eos_ingress {
+    // slot state: serial while free, serial + 1 while filled
+    eos_u16_t state[EOS_SIZE_PUB_INGRESS];
+    eos_topic_t topic[EOS_SIZE_PUB_INGRESS];
+    eos_u16_t tail;                                     // next serial to claim
+    eos_u16_t head;                                     // next serial to drain
+} eos_ingress_t;
+#endif
+
+#if (EOS_USE_EVENT_BRIDGE != 0)
+// 事件桥环中记录的头部，之后为数据，4字节对齐
+typedef struct eos_bridge_record {
+    eos_u16_t topic;
+    eos_u16_t size;
+} eos_bridge_record_t;
+
+#if (EOS_USE_BRIDGE_STREAM != 0)
+// 字节流传输，帧经COBS编码，以0x00结尾
+typedef struct eos_bridge_stream {
+    eos_u8_t tx[2][EOS_SIZE_BRIDGE_FRAME];                  // frame being filled and frame being sent
+    eos_u16_t tx_len;
+    eos_u16_t tx_code;                                      // index of the open COBS code byte
+    eos_u16_t tx_crc;
+    eos_u16_t tx_sealed;                                    // length of tx[1 - tx_index] to send, or 0
+    eos_u8_t tx_run;                                        // value of the open COBS code byte
+    eos_u8_t tx_index;                                      // tx[tx_index] is being filled
+    eos_u8_t tx_count;                                      // events in the frame being filled
+    eos_u8_t enabled;
+    eos_u8_t rx[EOS_SIZE_BRIDGE_FRAME];                     // decoded frame being received
+    eos_u16_t rx_len;
+    eos_u8_t rx_code;                                       // last COBS code byte
+    eos_u8_t rx_remain;                                     // data bytes left in the code block
+    eos_u8_t rx_overflow;
+    eos_u32_t lost;                                         // events dropped by both sides
+    eos_u32_t error;                                        // frames dropped by the receiver
+} eos_bridge_stream_t;
+#endif
+#endif
+
+#if (EOS_USE_HEAP_BIN != 0)
+#define EOS_HEAP_BIN_NUM                    6
+#endif
+
 typedef struct eos_heap {
+#if (EOS_USE_MAGIC != 0)
+    eos_u32_t magic;
+#endif
     eos_u8_t data[EOS_SIZE_HEAP];
     // word[0]
     eos_u32_t size                          : 15;       /* total size */
@@ -84,29 +221,106 @@ typedef struct eos_heap {
     // word[2]
     eos_u32_t current                       : 15;
     eos_u32_t empty                         : 1;
+    eos_u32_t tail                          : 15;       /* queue's last block */
     // word[2]
-    eos_sub_t sub_general;
-    eos_sub_t count;
+    eos_u16_t count;
+    // per-actor scan start in the queue, blocks before it hold no sub bit of the actor
+    eos_u16_t cursor[EOS_MAX_ACTORS];
+#if (EOS_USE_HEAP_BIN != 0)
+    // free lists of the size classes, linked by q_next
+    eos_u16_t bin[EOS_HEAP_BIN_NUM];
+    eos_u8_t bin_en;
+#endif
 } eos_heap_t;
 
+#if (EOS_USE_HSM_CACHE != 0)
+// 层次状态机拓扑中的一个状态，以其状态函数为键
+typedef struct eos_hsm_node {
+    eos_state_handler state;                                // EOS_NULL: empty slot
+    eos_state_handler parent;
+    struct eos_hsm_node *up;                                // node of parent, set on first use
+    eos_u8_t depth;                                         // eos_state_top is 0
+} eos_hsm_node_t;
+#endif
+
 typedef struct eos_tag {
+#if (EOS_USE_MAGIC != 0)
+    eos_u32_t magic;
+#endif
 #if (EOS_USE_PUB_SUB != 0)
-    eos_mcu_t *sub_table;                                     // event sub table
+    eos_sub_t *sub_table;                                     // event sub table
+#if (EOS_USE_SUB_CONST != 0)
+    eos_sub_t const *sub_const;                             // sub table fixed at compile time
+#endif
+    eos_topic_t topic_max;
 #endif
 
-    eos_mcu_t actor_exist;
-    eos_mcu_t actor_enabled;
+    eos_sub_t actor_exist;
+    eos_sub_t actor_enabled;
     eos_actor_t * actor[EOS_MAX_ACTORS];
+#if (EOS_USE_HSM_CACHE != 0)
+    eos_hsm_node_t hsm_node[EOS_MAX_HSM_STATES];            // states hashed by handler
+    eos_u16_t hsm_count;
+#endif
 
 #if (EOS_USE_EVENT_DATA != 0)
     eos_heap_t heap;
 #endif
+    eos_ring_t ring;
+#if (EOS_USE_PUB_INGRESS != 0)
+    eos_ingress_t ingress;
+#endif
+#if (EOS_USE_EVENT_BRIDGE != 0)
+    eos_bridge_ring_t *bridge_tx;                           // shared rings of the attached bridge
+    eos_bridge_ring_t *bridge_rx;
+    eos_topic_t bridge_topic[EOS_MAX_BRIDGE_TOPIC];         // topics exported to the peer
+    eos_u8_t bridge_count;
+#if (EOS_USE_BRIDGE_STREAM != 0)
+    eos_bridge_stream_t stream;
+#endif
+#endif
+    eos_sub_t sub_general;                                  // actors with events
+#if (EOS_USE_SUB_GROUP != 0)
+    eos_u8_t sub_group;                                     // bit g: sub_general byte g != 0
+#endif
+    // per-actor pending event count, sub_general bit i is set while pending[i] != 0
+    eos_u16_t pending[EOS_MAX_ACTORS];
+    eos_u32_t seq;                                          // publish order, 32-bit to compare old events
+    eos_u8_t batch;                                         // max events per actor per pass
+#if (EOS_USE_MULTI_WORKER != 0)
+    eos_sub_t worker_mask[EOS_MAX_WORKERS];                 // actors bound to each worker
+    eos_sub_t sub_busy;                                     // actors being dispatched
+    eos_u8_t worker_num;
+    eos_u8_t steal;                                         // idle workers steal ready actors
+#endif
+#if (EOS_USE_PREEMPT != 0)
+    eos_u8_t prio_run;                                      // running priority + 1 or ceiling, 0: idle
+#endif
 
 #if (EOS_USE_TIME_EVENT != 0)
     eos_event_timer_t etimer[EOS_MAX_TIME_EVENT];
     eos_u32_t time;
     eos_u32_t timeout_min;
-    eos_u8_t timer_count;
+    eos_u16_t timer_count;
+#if (EOS_USE_TIMER_MIN_HEAP != 0)
+    // min-heap of etimer indexes ordered by timeout_ms, and each timer's place in it
+    eos_u16_t timer_heap[EOS_MAX_TIME_EVENT];
+    eos_u16_t timer_pos[EOS_MAX_TIME_EVENT];
+    eos_u16_t timer_heap_size;
+    // etimer indexes hashed by topic, chained by timer_next
+    eos_u16_t timer_hash[EOS_TIMER_HASH_SIZE];
+    eos_u16_t timer_next[EOS_MAX_TIME_EVENT];
+#endif
+    // actors parked by eos_delay(), and those of them dropping blocked events
+    eos_sub_t sub_delay;
+    eos_sub_t sub_block;
+    eos_u32_t delay_ms[EOS_MAX_ACTORS];                     // wake-up time of each actor
+    eos_u32_t delay_min;
+    eos_topic_t unblocked[EOS_MAX_UNBLOCKED_TOPIC];
+    eos_u8_t unblocked_count;
+#if (EOS_USE_MULTI_WORKER == 0)
+    eos_u8_t actor_run;                                     // running actor, EOS_MAX_ACTORS: none
+#endif
 #endif
 
     eos_u8_t enabled                        : 1;
@@ -116,10 +330,16 @@ typedef struct eos_tag {
 
 /* eventos API for test ----------------------------- */
 eos_s8_t eos_once(void);
+#if (EOS_USE_MULTI_WORKER != 0)
+eos_s8_t eos_worker_once(eos_u8_t worker);
+#endif
 eos_s8_t eos_event_pub_ret(eos_topic_t topic, void *data, eos_u32_t size);
 void * eos_get_framework(void);
 void eos_event_pub_time(eos_topic_t topic, eos_u32_t time_ms, eos_bool_t oneshoot);
 void eos_set_time(eos_u32_t time_ms);
+#if (EOS_USE_TIME_EVENT != 0)
+eos_u8_t eos_actor_current(void);
+#endif
 // **eos end** -----------------------------------------------------------------
 
 #endif
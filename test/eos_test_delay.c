@@ -0,0 +1,118 @@
+/* include ------------------------------------------------------------------ */
+#include "eos_test.h"
+#include "eventos.h"
+#include "event_def.h"
+#include "unity.h"
+#include "eos_test_def.h"
+
+#if (EOS_USE_TIME_EVENT != 0 && EOS_USE_PUB_SUB != 0)
+/* unittest ----------------------------------------------------------------- */
+#define DELAY_TEST_ACTORS                       3
+
+static eos_reactor_t delay_actor[DELAY_TEST_ACTORS];
+static eos_u8_t log_priority[16];
+static eos_topic_t log_topic[16];
+static eos_u32_t log_count;
+static eos_bool_t delay_block;
+static eos_t *f;
+
+static void delay_handler(eos_reactor_t * const me, eos_event_t const * const e)
+{
+    if (log_count < 16) {
+        log_priority[log_count] = me->super.priority;
+        log_topic[log_count] = e->topic;
+    }
+    log_count ++;
+
+    // Actor 1收到Event_TestReactor后延时100ms
+    if (e->topic == Event_TestReactor) {
+        if (delay_block == EOS_True) {
+            eos_delay_unsub_event(100);
+        }
+        else {
+            eos_delay(100);
+        }
+    }
+}
+
+static void delay_setup(eos_bool_t block)
+{
+    eos_set_time(0);
+    f = eos_test_setup(Event_Max);
+    eos_test_reactors(delay_actor, DELAY_TEST_ACTORS, delay_handler);
+    for (eos_u8_t i = 0; i < DELAY_TEST_ACTORS; i ++) {
+        eos_event_sub(&delay_actor[i].super, Event_Test);
+    }
+    eos_event_sub(&delay_actor[1].super, Event_TestReactor);
+    eos_event_sub(&delay_actor[1].super, Event_TestFsm);
+    log_count = 0;
+    delay_block = block;
+
+    // Actor 1开始延时
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestReactor, EOS_NULL, 0));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_UINT32(1, log_count);
+    TEST_ASSERT_EQUAL_UINT32(EOS_SUB_BIT(1), f->sub_delay);
+    TEST_ASSERT_EQUAL_UINT32(100, eos_time_next());
+}
+#endif
+
+void eos_test_delay(void)
+{
+#if (EOS_USE_TIME_EVENT != 0 && EOS_USE_PUB_SUB != 0)
+    // 延时中的Actor不处理事件，其他Actor照常调度 ----------------------------------
+    delay_setup(EOS_False);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestFsm, EOS_NULL, 0));
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(3, log_count);
+    TEST_ASSERT_EQUAL_UINT8(2, log_priority[1]);
+    TEST_ASSERT_EQUAL_UINT8(0, log_priority[2]);
+    // Actor 1的事件保留在队列中
+    TEST_ASSERT_EQUAL_UINT16(2, f->pending[1]);
+
+    set_time_ms(99);
+    TEST_ASSERT_EQUAL_UINT32(1, eos_time_next());
+    TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
+    TEST_ASSERT_EQUAL_UINT32(3, log_count);
+
+    // 延时完毕，按发布顺序处理延时期间的事件
+    set_time_ms(100);
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(5, log_count);
+    TEST_ASSERT_EQUAL_UINT8(1, log_priority[3]);
+    TEST_ASSERT_EQUAL_UINT16(Event_Test, log_topic[3]);
+    TEST_ASSERT_EQUAL_UINT16(Event_TestFsm, log_topic[4]);
+    TEST_ASSERT_EQUAL_UINT32(0, f->sub_delay);
+    TEST_ASSERT_EQUAL_UINT32(EOS_TIME_FOREVER, eos_time_next());
+
+    // 屏蔽事件接收的延时，只保留不可阻塞事件 -------------------------------------
+    delay_setup(EOS_True);
+    eos_event_set_unblocked(Event_TestFsm);
+    eos_event_set_unblocked(Event_TestFsm);
+    TEST_ASSERT_EQUAL_UINT8(1, f->unblocked_count);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestFsm, EOS_NULL, 0));
+    // 所有订阅者都在延时中，事件被丢弃
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestReactor, EOS_NULL, 0));
+#if (EOS_USE_EVENT_DATA != 0)
+    eos_u8_t data[4] = { 0 };
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestReactor, data, 4));
+#endif
+    TEST_ASSERT_EQUAL_UINT16(1, f->pending[1]);
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(3, log_count);
+
+    set_time_ms(100);
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(4, log_count);
+    TEST_ASSERT_EQUAL_UINT8(1, log_priority[3]);
+    TEST_ASSERT_EQUAL_UINT16(Event_TestFsm, log_topic[3]);
+    TEST_ASSERT_EQUAL_UINT32(0, f->sub_block);
+
+    // 延时完毕后，重新接收全部事件
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(7, log_count);
+#endif
+}
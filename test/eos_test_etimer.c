@@ -5,12 +5,12 @@
 #include "unity_pack.h"
 #include "eos_test_def.h"
 
-#if (EOS_USE_SM_MODE != 0)
 #if (EOS_USE_TIME_EVENT != 0)
 /* unit test ---------------------------------------------------------------- */
-static eos_mcu_t sub_table[Event_Max];
-static fsm_t fsm;
+static eos_sub_t sub_table[Event_Max];
 static eos_t *f;
+#if (EOS_USE_SM_MODE != 0)
+static fsm_t fsm;
 #endif
 #endif
 
@@ -254,6 +254,174 @@ void eos_test_etimer(void)
     TEST_ASSERT_EQUAL_UINT32((system_time + 700), f->etimer[0].timeout_ms);
     eos_event_time_cancel(Event_TestFsm);
     TEST_ASSERT_EQUAL_UINT8(0, f->timer_count);
+
+    // 对Tickless接口进行单元测试
+    eos_set_time(0);
+    TEST_ASSERT_EQUAL_UINT32(EOS_TIME_FOREVER, eos_time_next());
+    eos_event_pub_delay(Event_Time_500ms, 500);
+    TEST_ASSERT_EQUAL_UINT32(500, eos_time_next());
+    eos_tick_advance(200);
+    TEST_ASSERT_EQUAL_UINT32(200, eos_time());
+    TEST_ASSERT_EQUAL_UINT32(300, eos_time_next());
+    eos_tick();
+    TEST_ASSERT_EQUAL_UINT32(200 + EOS_TICK_MS, eos_time());
+    eos_tick_advance(10000);
+    TEST_ASSERT_EQUAL_UINT32(0, eos_time_next());
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_UINT8(0, f->timer_count);
+    TEST_ASSERT_EQUAL_UINT32(EOS_TIME_FOREVER, eos_time_next());
+
+    // 一次跨越回绕点，已到期但尚未处理的定时器立即触发
+    eos_set_time(EOS_MS_NUM_30DAY - 100);
+    eos_event_pub_delay(Event_Time_500ms, 50);
+    eos_event_pub_delay(Event_TestFsm, 1000);
+    eos_tick_advance(200);
+    TEST_ASSERT_EQUAL_UINT32(100, eos_time());
+    TEST_ASSERT_EQUAL_UINT32(0, f->etimer[0].timeout_ms);
+    TEST_ASSERT_EQUAL_UINT32(900, f->etimer[1].timeout_ms);
+    TEST_ASSERT_EQUAL_UINT32(0, eos_time_next());
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_UINT8(1, f->timer_count);
+    TEST_ASSERT_EQUAL_UINT32(800, eos_time_next());
+    eos_event_time_cancel(Event_TestFsm);
+    TEST_ASSERT_EQUAL_UINT8(0, f->timer_count);
+
+    // 接近回绕点时休眠将近30天，时间与休眠时长之和超出32位，依然正确回绕
+    eos_set_time(EOS_MS_NUM_30DAY - 100);
+    eos_event_pub_delay(Event_Time_500ms, 50);
+    eos_event_pub_delay(Event_TestFsm, 1000);
+    eos_tick_advance(EOS_MS_NUM_30DAY - 1000);
+    TEST_ASSERT_EQUAL_UINT32(EOS_MS_NUM_30DAY - 1100, eos_time());
+    TEST_ASSERT_EQUAL_UINT32(0, f->etimer[0].timeout_ms);
+    TEST_ASSERT_EQUAL_UINT32(900, f->etimer[1].timeout_ms);
+    TEST_ASSERT_EQUAL_UINT32(0, eos_time_next());
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_UINT8(0, f->timer_count);
+    TEST_ASSERT_EQUAL_UINT32(EOS_TIME_FOREVER, eos_time_next());
+#endif
+#endif
+}
+
+#if (EOS_USE_TIME_EVENT != 0 && EOS_USE_TIMER_MIN_HEAP != 0)
+static eos_reactor_t timer_reactor;
+static eos_topic_t timer_log[64];
+static eos_u32_t timer_log_count;
+
+static void timer_handler(eos_reactor_t * const me, eos_event_t const * const e)
+{
+    (void)me;
+    if (timer_log_count < 64) {
+        timer_log[timer_log_count] = e->topic;
+    }
+    timer_log_count ++;
+}
+
+// 检查最小堆、位置表与哈希表的一致性
+static void timer_check(void)
+{
+    eos_u32_t timeout_min = EOS_U32_MAX;
+
+    TEST_ASSERT_EQUAL_UINT16(f->timer_count, f->timer_heap_size);
+    for (eos_u32_t pos = 0; pos < f->timer_heap_size; pos ++) {
+        eos_u16_t index = f->timer_heap[pos];
+        TEST_ASSERT(index < f->timer_count);
+        TEST_ASSERT_EQUAL_UINT16(pos, f->timer_pos[index]);
+        if (pos > 0) {
+            eos_u16_t parent = f->timer_heap[(pos - 1) / 2];
+            TEST_ASSERT(f->etimer[parent].timeout_ms <= f->etimer[index].timeout_ms);
+        }
+        if (f->etimer[index].timeout_ms < timeout_min) {
+            timeout_min = f->etimer[index].timeout_ms;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(timeout_min, f->timeout_min);
+
+    eos_u32_t hashed = 0;
+    for (eos_u32_t i = 0; i < EOS_TIMER_HASH_SIZE; i ++) {
+        for (eos_u16_t index = f->timer_hash[i];
+             index != EOS_TIMER_NULL; index = f->timer_next[index]) {
+            TEST_ASSERT(index < f->timer_count);
+            TEST_ASSERT_EQUAL_UINT32(i, f->etimer[index].topic & (EOS_TIMER_HASH_SIZE - 1));
+            hashed ++;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(f->timer_count, hashed);
+}
+#endif
+
+void eos_test_etimer_heap(void)
+{
+#if (EOS_USE_TIME_EVENT != 0 && EOS_USE_TIMER_MIN_HEAP != 0)
+    f = eos_get_framework();
+    eos_set_time(0);
+    eos_init();
+#if (EOS_USE_PUB_SUB != 0)
+    eos_sub_init(sub_table, Event_Max);
+#endif
+    timer_reactor.super.enabled = EOS_False;
+    eos_reactor_init(&timer_reactor, 0, EOS_NULL);
+    eos_reactor_start(&timer_reactor, timer_handler);
+#if (EOS_USE_PUB_SUB != 0)
+    for (eos_topic_t topic = Event_Test; topic < Event_ActEnd; topic ++) {
+        eos_event_sub(&timer_reactor.super, topic);
+    }
 #endif
+
+    // 随机添加与取消，不到期 -------------------------------------------------------
+    eos_u8_t added[EOS_MAX_TIME_EVENT * 2] = { 0 };
+    eos_u32_t seed = 12345;
+    for (eos_u32_t i = 0; i < 4000; i ++) {
+        seed = seed * 1103515245 + 12345;
+        eos_u32_t k = (seed >> 16) % (EOS_MAX_TIME_EVENT * 2);
+        eos_topic_t topic = (eos_topic_t)(1000 + k * 7);
+        if (added[k] != 0) {
+            eos_event_time_cancel(topic);
+            added[k] = 0;
+        }
+        else if (f->timer_count < EOS_MAX_TIME_EVENT) {
+            eos_event_pub_delay(topic, 100000 + ((seed >> 8) % 50000));
+            added[k] = 1;
+        }
+        timer_check();
+    }
+    for (eos_u32_t k = 0; k < (EOS_MAX_TIME_EVENT * 2); k ++) {
+        if (added[k] != 0) {
+            eos_event_time_cancel((eos_topic_t)(1000 + k * 7));
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, f->timer_count);
+    TEST_ASSERT_EQUAL_UINT32(EOS_U32_MAX, f->timeout_min);
+
+    // 按超时时间依次到期 -----------------------------------------------------------
+    timer_log_count = 0;
+    eos_event_pub_delay(Event_Time_2000ms, 2000);
+    eos_event_pub_delay(Event_Test, 300);
+    eos_event_pub_period(Event_Time_500ms, 500);
+    eos_event_pub_delay(Event_TestHsm, 1200);
+    timer_check();
+    for (eos_u32_t t = 0; t <= 2000; t += 100) {
+        eos_set_time(t);
+        while (eos_once() == EosRun_OK);
+        timer_check();
+    }
+    TEST_ASSERT_EQUAL_UINT32(7, timer_log_count);
+    TEST_ASSERT_EQUAL_UINT16(Event_Test, timer_log[0]);
+    TEST_ASSERT_EQUAL_UINT16(Event_Time_500ms, timer_log[1]);
+    TEST_ASSERT_EQUAL_UINT16(Event_Time_500ms, timer_log[2]);
+    TEST_ASSERT_EQUAL_UINT16(Event_TestHsm, timer_log[3]);
+    TEST_ASSERT_EQUAL_UINT16(Event_Time_500ms, timer_log[4]);
+    TEST_ASSERT_EQUAL_UINT16((Event_Time_500ms + Event_Time_2000ms), (timer_log[5] + timer_log[6]));
+    TEST_ASSERT_EQUAL_UINT16(1, f->timer_count);
+
+    // 周期事件落后多个周期时，每次检查最多触发一次
+    timer_log_count = 0;
+    eos_set_time(3600);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_UINT32(1, timer_log_count);
+    TEST_ASSERT_EQUAL_UINT32(3000, f->timeout_min);
+    timer_check();
+    eos_event_time_cancel(Event_Time_500ms);
+    TEST_ASSERT_EQUAL_UINT16(0, f->timer_count);
 #endif
 }
@@ -9,7 +9,7 @@
 #if (EOS_USE_SM_MODE != 0)
 /* unit test ---------------------------------------------------------------- */
 #if (EOS_USE_PUB_SUB != 0)
-static eos_mcu_t sub_table[Event_Max];
+static eos_sub_t sub_table[Event_Max];
 #endif
 static fsm_t fsm, fsm2;
 static eos_t *f;
@@ -52,12 +52,12 @@ void eos_test_event(void)
     TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
 #if (EOS_USE_PUB_SUB != 0)
     TEST_ASSERT_EQUAL_INT8(EosRun_NoActorSub, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
-    TEST_ASSERT_EQUAL_INT8(0, f->heap.sub_general);
-    TEST_ASSERT_EQUAL_INT8(0, f->heap.count);
+    TEST_ASSERT_EQUAL_INT8(0, f->sub_general);
+    TEST_ASSERT_EQUAL_INT8(0, f->ring.count);
 #else
     TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
-    TEST_ASSERT_EQUAL_INT8(1, f->heap.count);
-    TEST_ASSERT_EQUAL_INT8(1, f->heap.sub_general);
+    TEST_ASSERT_EQUAL_INT8(1, f->ring.count);
+    TEST_ASSERT_EQUAL_INT8(1, f->sub_general);
     TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
     TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
     TEST_ASSERT_EQUAL_UINT8(1, f->heap.empty);
@@ -67,8 +67,8 @@ void eos_test_event(void)
     // eos_event_pub_ret
     for (int i = 0; i < EOS_EVENT_PUB_TIMES; i ++) {
         TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestFsm, EOS_NULL, 0));
-        TEST_ASSERT_EQUAL_INT8((1 + i), f->heap.count);
-        TEST_ASSERT_EQUAL_INT8(1, f->heap.sub_general);
+        TEST_ASSERT_EQUAL_INT8((1 + i), f->ring.count);
+        TEST_ASSERT_EQUAL_INT8(1, f->sub_general);
         TEST_ASSERT_EQUAL_UINT32(0, fsm_state(&fsm));
         TEST_ASSERT_EQUAL_UINT32(0, fsm_event_count(&fsm));
     }
@@ -82,7 +82,7 @@ void eos_test_event(void)
         TEST_ASSERT_EQUAL_UINT32(state, fsm_state(&fsm));
         TEST_ASSERT_EQUAL_UINT32((1 + i), fsm_event_count(&fsm));
 
-        TEST_ASSERT_EQUAL_INT8((EOS_EVENT_PUB_TIMES - 1 - i), f->heap.count);
+        TEST_ASSERT_EQUAL_INT8((EOS_EVENT_PUB_TIMES - 1 - i), f->ring.count);
     }
 
     TEST_ASSERT_EQUAL_UINT32(0, fsm_state(&fsm));
@@ -96,13 +96,13 @@ void eos_test_event(void)
 
     for (int i = 0; i < EOS_EVENT_PUB_TIMES; i ++) {
         TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestFsm, EOS_NULL, 0));
-        TEST_ASSERT_EQUAL_INT8((1 + i), f->heap.count);
-        TEST_ASSERT_EQUAL_INT8(3, f->heap.sub_general);
+        TEST_ASSERT_EQUAL_INT8((1 + i), f->ring.count);
+        TEST_ASSERT_EQUAL_INT8(3, f->sub_general);
         TEST_ASSERT_EQUAL_UINT32(0, fsm_state(&fsm));
         TEST_ASSERT_EQUAL_UINT32(0, fsm_event_count(&fsm));
     }
 
-    TEST_ASSERT_EQUAL_UINT32(3, f->heap.sub_general);
+    TEST_ASSERT_EQUAL_UINT32(3, f->sub_general);
 
     for (int i = 0; i < EOS_EVENT_PUB_TIMES; i ++) {
         state = (i % 2 == 1) ? 1 : 0;
@@ -115,10 +115,10 @@ void eos_test_event(void)
         TEST_ASSERT_EQUAL_UINT32((1 + i), fsm_event_count(&fsm2));
         TEST_ASSERT_EQUAL_UINT32(0, fsm_event_count(&fsm));
 
-        TEST_ASSERT_EQUAL_INT8(EOS_EVENT_PUB_TIMES, f->heap.count);
+        TEST_ASSERT_EQUAL_INT8(EOS_EVENT_PUB_TIMES, f->ring.count);
     }
 
-    TEST_ASSERT_EQUAL_UINT32(1, f->heap.sub_general);
+    TEST_ASSERT_EQUAL_UINT32(1, f->sub_general);
 
     for (int i = 0; i < EOS_EVENT_PUB_TIMES; i ++) {
         state = (i % 2 == 1) ? 1 : 0;
@@ -131,13 +131,62 @@ void eos_test_event(void)
         TEST_ASSERT_EQUAL_UINT32((1 + i), fsm_event_count(&fsm));
         TEST_ASSERT_EQUAL_UINT32(EOS_EVENT_PUB_TIMES, fsm_event_count(&fsm2));
 
-        TEST_ASSERT_EQUAL_INT8((EOS_EVENT_PUB_TIMES - 1 - i), f->heap.count);
+        TEST_ASSERT_EQUAL_INT8((EOS_EVENT_PUB_TIMES - 1 - i), f->ring.count);
     }
 
-    TEST_ASSERT_EQUAL_UINT32(0, f->heap.sub_general);
+    TEST_ASSERT_EQUAL_UINT32(0, f->sub_general);
     TEST_ASSERT_EQUAL_UINT32(EOS_HEAP_MAX, f->heap.queue);
 
     TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
     TEST_ASSERT_EQUAL_UINT8(1, f->heap.empty);
+
+#if (EOS_USE_EVENT_DATA != 0)
+    // 零拷贝发布，提交之前，事件不会被分发
+    eos_u8_t *data = eos_event_alloc(Event_TestFsm, 8);
+    TEST_ASSERT_NOT_NULL(data);
+    TEST_ASSERT_EQUAL_UINT8(1, f->heap.empty);
+    TEST_ASSERT_EQUAL_UINT16(1, f->heap.count);
+    TEST_ASSERT_EQUAL_UINT32(0, f->sub_general);
+    TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
+    // 提交之前发布的事件，先被分发
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestFsm, EOS_NULL, 0));
+    for (eos_u8_t i = 0; i < 8; i ++) {
+        data[i] = i;
+    }
+    eos_event_commit(data);
+    TEST_ASSERT_EQUAL_UINT8(0, f->heap.empty);
+    TEST_ASSERT_EQUAL_UINT32(3, f->sub_general);
+    TEST_ASSERT_EQUAL_UINT8(2, f->pending[0]);
+    TEST_ASSERT_EQUAL_UINT8(2, f->pending[1]);
+    eos_event_inner_t *e = (eos_event_inner_t *)(data - sizeof(eos_event_inner_t));
+    TEST_ASSERT_EQUAL_UINT16(Event_TestFsm, e->topic);
+    TEST_ASSERT_EQUAL_UINT32(f->seq - 1, e->seq);
+    TEST_ASSERT_EQUAL_UINT16(1, f->ring.count);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_UINT32(3, e->sub);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_UINT32(1, e->sub);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
+    TEST_ASSERT_EQUAL_UINT8(1, f->heap.empty);
+    TEST_ASSERT_EQUAL_UINT16(0, f->heap.count);
+    TEST_ASSERT_EQUAL_UINT32(0, f->ring.count);
+
+    // 申请之后，订阅者全部取消订阅，提交时直接释放
+#if (EOS_USE_PUB_SUB != 0)
+    TEST_ASSERT_NULL(eos_event_alloc(Event_Test, 8));
+    data = eos_event_alloc(Event_TestFsm, 8);
+    TEST_ASSERT_NOT_NULL(data);
+    eos_event_unsub(&fsm.super.super, Event_TestFsm);
+    eos_event_unsub(&fsm2.super.super, Event_TestFsm);
+    eos_event_commit(data);
+    TEST_ASSERT_EQUAL_UINT16(0, f->heap.count);
+    TEST_ASSERT_EQUAL_UINT32(0, f->sub_general);
+    TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
+    eos_event_sub(&fsm.super.super, Event_TestFsm);
+    eos_event_sub(&fsm2.super.super, Event_TestFsm);
+#endif
+#endif
 #endif
 }
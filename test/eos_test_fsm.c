@@ -9,17 +9,13 @@
 
 /* unittest ----------------------------------------------------------------- */
 #if (EOS_USE_PUB_SUB != 0)
-static eos_mcu_t eos_sub_table[Event_Max];
+static eos_sub_t eos_sub_table[Event_Max];
 #endif
-#if (EOS_USE_HSM_MODE == 0)
 static fsm_t fsm, fsm2;
 static eos_t *f;
-#endif
 
 void eos_test_fsm(void)
 {
-#if (EOS_USE_HSM_MODE == 0)
-    eos_s8_t ret;
     f = eos_get_framework();
 
     // 测试尚未注册Actor的情况
@@ -36,12 +32,12 @@ void eos_test_fsm(void)
     TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
 #if (EOS_USE_PUB_SUB != 0)
     TEST_ASSERT_EQUAL_INT8(EosRun_NoActorSub, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
-    TEST_ASSERT_EQUAL_INT8(0, f->heap.sub_general);
-    TEST_ASSERT_EQUAL_INT8(0, f->heap.count);
+    TEST_ASSERT_EQUAL_INT8(0, f->sub_general);
+    TEST_ASSERT_EQUAL_INT8(0, f->ring.count);
 #else
     TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
-    TEST_ASSERT_EQUAL_INT8(1, f->heap.count);
-    TEST_ASSERT_EQUAL_INT8(1, f->heap.sub_general);
+    TEST_ASSERT_EQUAL_INT8(1, f->ring.count);
+    TEST_ASSERT_EQUAL_INT8(1, f->sub_general);
     TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
     TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
     TEST_ASSERT_EQUAL_UINT8(1, f->heap.empty);
@@ -51,8 +47,8 @@ void eos_test_fsm(void)
     // eos_event_pub_ret
     for (int i = 0; i < EOS_EVENT_PUB_TIMES; i ++) {
         TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestFsm, EOS_NULL, 0));
-        TEST_ASSERT_EQUAL_INT8((1 + i), f->heap.count);
-        TEST_ASSERT_EQUAL_INT8(1, f->heap.sub_general);
+        TEST_ASSERT_EQUAL_INT8((1 + i), f->ring.count);
+        TEST_ASSERT_EQUAL_INT8(1, f->sub_general);
         TEST_ASSERT_EQUAL_UINT32(0, fsm_state(&fsm));
         TEST_ASSERT_EQUAL_UINT32(0, fsm_event_count(&fsm));
     }
@@ -66,7 +62,7 @@ void eos_test_fsm(void)
         TEST_ASSERT_EQUAL_UINT32(state, fsm_state(&fsm));
         TEST_ASSERT_EQUAL_UINT32((1 + i), fsm_event_count(&fsm));
 
-        TEST_ASSERT_EQUAL_INT8((EOS_EVENT_PUB_TIMES - 1 - i), f->heap.count);
+        TEST_ASSERT_EQUAL_INT8((EOS_EVENT_PUB_TIMES - 1 - i), f->ring.count);
     }
 
     TEST_ASSERT_EQUAL_UINT32(0, fsm_state(&fsm));
@@ -80,13 +76,13 @@ void eos_test_fsm(void)
 
     for (int i = 0; i < EOS_EVENT_PUB_TIMES; i ++) {
         TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestFsm, EOS_NULL, 0));
-        TEST_ASSERT_EQUAL_INT8((1 + i), f->heap.count);
-        TEST_ASSERT_EQUAL_INT8(3, f->heap.sub_general);
+        TEST_ASSERT_EQUAL_INT8((1 + i), f->ring.count);
+        TEST_ASSERT_EQUAL_INT8(3, f->sub_general);
         TEST_ASSERT_EQUAL_UINT32(0, fsm_state(&fsm));
         TEST_ASSERT_EQUAL_UINT32(0, fsm_event_count(&fsm));
     }
 
-    TEST_ASSERT_EQUAL_UINT32(3, f->heap.sub_general);
+    TEST_ASSERT_EQUAL_UINT32(3, f->sub_general);
 
     for (int i = 0; i < EOS_EVENT_PUB_TIMES; i ++) {
         state = (i % 2 == 1) ? 1 : 0;
@@ -99,10 +95,10 @@ void eos_test_fsm(void)
         TEST_ASSERT_EQUAL_UINT32((1 + i), fsm_event_count(&fsm2));
         TEST_ASSERT_EQUAL_UINT32(0, fsm_event_count(&fsm));
 
-        TEST_ASSERT_EQUAL_INT8(EOS_EVENT_PUB_TIMES, f->heap.count);
+        TEST_ASSERT_EQUAL_INT8(EOS_EVENT_PUB_TIMES, f->ring.count);
     }
 
-    TEST_ASSERT_EQUAL_UINT32(1, f->heap.sub_general);
+    TEST_ASSERT_EQUAL_UINT32(1, f->sub_general);
 
     for (int i = 0; i < EOS_EVENT_PUB_TIMES; i ++) {
         state = (i % 2 == 1) ? 1 : 0;
@@ -115,14 +111,21 @@ void eos_test_fsm(void)
         TEST_ASSERT_EQUAL_UINT32((1 + i), fsm_event_count(&fsm));
         TEST_ASSERT_EQUAL_UINT32(EOS_EVENT_PUB_TIMES, fsm_event_count(&fsm2));
 
-        TEST_ASSERT_EQUAL_INT8((EOS_EVENT_PUB_TIMES - 1 - i), f->heap.count);
+        TEST_ASSERT_EQUAL_INT8((EOS_EVENT_PUB_TIMES - 1 - i), f->ring.count);
     }
 
-    TEST_ASSERT_EQUAL_UINT32(0, f->heap.sub_general);
+    TEST_ASSERT_EQUAL_UINT32(0, f->sub_general);
     TEST_ASSERT_EQUAL_UINT32(EOS_HEAP_MAX, f->heap.queue);
 
     TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
     TEST_ASSERT_EQUAL_UINT8(1, f->heap.empty);
+
+#if (EOS_USE_HSM_TRAN_CACHE != 0)
+    // 两个状态之间的往返，各缓存一个转换
+    TEST_ASSERT_EQUAL_UINT8(2, fsm.super.tran_count);
+    TEST_ASSERT_EQUAL_UINT8(2, fsm2.super.tran_count);
+    TEST_ASSERT(fsm.super.tran[0].lca == EOS_STATE_CAST(eos_state_top));
+    TEST_ASSERT_EQUAL_UINT8(1, fsm.super.tran[0].enter_num);
 #endif
 }
 
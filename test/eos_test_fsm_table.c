@@ -0,0 +1,133 @@
+/* include ------------------------------------------------------------------ */
+#include "eos_test.h"
+#include "eventos.h"
+#include "event_def.h"
+#include "unity.h"
+#include "eos_test_def.h"
+
+#if (EOS_USE_FSM_TABLE != 0 && EOS_USE_PUB_SUB != 0)
+/* unittest ----------------------------------------------------------------- */
+enum {
+    State_Idle = 0,
+    State_Wait,
+    State_Done,
+
+    State_Max
+};
+
+#define LOG_ENTER                               0x10
+#define LOG_EXIT                                0x20
+#define LOG_ACTION                              0x30
+
+typedef struct table_fsm {
+    eos_fsm_t super;
+    eos_u8_t log[16];
+    eos_u32_t log_count;
+    eos_topic_t enter_topic;
+} table_fsm_t;
+
+static table_fsm_t fsm;
+
+static void table_log(table_fsm_t * const me, eos_u8_t kind)
+{
+    if (me->log_count < 16) {
+        me->log[me->log_count] = kind | me->super.state;
+    }
+    me->log_count ++;
+}
+
+static void table_enter(table_fsm_t * const me, eos_event_t const * const e)
+{
+    me->enter_topic = e->topic;
+    table_log(me, LOG_ENTER);
+}
+
+static void table_exit(table_fsm_t * const me, eos_event_t const * const e)
+{
+    (void)e;
+    table_log(me, LOG_EXIT);
+}
+
+static void table_action(table_fsm_t * const me, eos_event_t const * const e)
+{
+    (void)e;
+    table_log(me, LOG_ACTION);
+}
+
+// 表中只有Event_Test ~ Event_TestHsm三个主题
+static const eos_fsm_tran_t table_tran[State_Max][Event_TestReactor - Event_User] = {
+    EOS_FSM_ROW(State_Idle,
+        EOS_FSM_ON(Event_Test, table_action, State_Wait),
+        EOS_FSM_ON(Event_TestHsm, table_action, EOS_FSM_STAY)),
+    EOS_FSM_ROW(State_Wait,
+        EOS_FSM_ON(Event_Test, table_action, State_Wait),
+        EOS_FSM_ON(Event_TestFsm, EOS_NULL, State_Done)),
+    EOS_FSM_ROW(State_Done,
+        EOS_FSM_ON(Event_Test, EOS_NULL, State_Idle)),
+};
+
+static const eos_fsm_state_t table_state[State_Max] = {
+    { EOS_FSM_ACTION_CAST(table_enter), EOS_FSM_ACTION_CAST(table_exit) },
+    { EOS_FSM_ACTION_CAST(table_enter), EOS_FSM_ACTION_CAST(table_exit) },
+    { EOS_FSM_ACTION_CAST(table_enter), EOS_FSM_ACTION_CAST(table_exit) },
+};
+
+static const eos_fsm_table_t table =
+    EOS_FSM_TABLE(table_tran, table_state, State_Max, Event_TestReactor);
+
+static void table_pub(eos_topic_t topic)
+{
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(topic, EOS_NULL, 0));
+    while (eos_once() == EosRun_OK);
+}
+#endif
+
+void eos_test_fsm_table(void)
+{
+#if (EOS_USE_FSM_TABLE != 0 && EOS_USE_PUB_SUB != 0)
+    (void)eos_test_setup(Event_Max);
+    fsm.log_count = 0;
+    fsm.super.super.super.enabled = EOS_False;
+    eos_fsm_init(&fsm.super, 0, &table);
+    for (eos_topic_t topic = Event_Test; topic <= Event_TestReactor; topic ++) {
+        eos_event_sub(&fsm.super.super.super, topic);
+    }
+
+    // 启动时进入初始状态 --------------------------------------------------------
+    eos_fsm_start(&fsm.super, State_Idle);
+    TEST_ASSERT_EQUAL_UINT8(State_Idle, fsm.super.state);
+    TEST_ASSERT_EQUAL_UINT32(1, fsm.log_count);
+    TEST_ASSERT_EQUAL_UINT8(LOG_ENTER | State_Idle, fsm.log[0]);
+    TEST_ASSERT_EQUAL_UINT16(Event_Null, fsm.enter_topic);
+
+    // 外部转换：动作、退出、进入，进入动作收到引起转换的事件 --------------------
+    table_pub(Event_Test);
+    TEST_ASSERT_EQUAL_UINT8(State_Wait, fsm.super.state);
+    TEST_ASSERT_EQUAL_UINT16(Event_Test, fsm.enter_topic);
+    // 该状态的行中没有的事件，以及表外的主题，都被忽略
+    table_pub(Event_TestHsm);
+    table_pub(Event_TestReactor);
+    TEST_ASSERT_EQUAL_UINT8(State_Wait, fsm.super.state);
+    TEST_ASSERT_EQUAL_UINT32(4, fsm.log_count);
+    // 自身转换也退出并重新进入
+    table_pub(Event_Test);
+    // 没有动作的转换
+    table_pub(Event_TestFsm);
+    table_pub(Event_Test);
+    TEST_ASSERT_EQUAL_UINT8(State_Idle, fsm.super.state);
+    // 内部转换只执行动作
+    table_pub(Event_TestHsm);
+    TEST_ASSERT_EQUAL_UINT8(State_Idle, fsm.super.state);
+
+    static const eos_u8_t order[] = {
+        LOG_ENTER | State_Idle,
+        LOG_ACTION | State_Idle, LOG_EXIT | State_Idle, LOG_ENTER | State_Wait,
+        LOG_ACTION | State_Wait, LOG_EXIT | State_Wait, LOG_ENTER | State_Wait,
+        LOG_EXIT | State_Wait, LOG_ENTER | State_Done,
+        LOG_EXIT | State_Done, LOG_ENTER | State_Idle,
+        LOG_ACTION | State_Idle,
+    };
+    TEST_ASSERT_EQUAL_UINT32(sizeof(order), fsm.log_count);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(order, fsm.log, sizeof(order));
+#endif
+}
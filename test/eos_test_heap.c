@@ -9,6 +9,7 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include "eos_test_def.h"
+#include <string.h>
 
 /* heap function ------------------------------------------------------------ */
 void eos_heap_init(eos_heap_t * const me);
@@ -16,6 +17,10 @@ void * eos_heap_malloc(eos_heap_t * const me, eos_u32_t size);
 void eos_heap_free(eos_heap_t * const me, void * data);
 void *eos_heap_get_block(eos_heap_t * const me, eos_u8_t priority);
 void eos_heap_gc(eos_heap_t * const me, void *data);
+#if (EOS_USE_HEAP_BIN != 0)
+void eos_heap_init_bin(eos_heap_t * const me);
+void eos_heap_bin_flush(eos_heap_t * const me);
+#endif
 
 /* test data & function ----------------------------------------------------- */
 #define EOS_HEAP_TEST_PRINT_UNIT                10
@@ -25,6 +30,7 @@ static eos_heap_t heap;
 uint8_t * p_data;
 
 static void print_heap_list(eos_heap_t * const me, eos_u32_t index);
+eos_u32_t heap_stress(eos_heap_t * const me, eos_u32_t times, eos_u32_t seed);
 
 /* test function ------------------------------------------------------------ */
 void eos_test_heap(void)
@@ -44,7 +50,7 @@ void eos_test_heap(void)
         eblock[i] = eos_heap_malloc(&heap, (i + 32));
         TEST_ASSERT_NOT_NULL(eblock[i]);
         eos_event_inner_t *e = (eos_event_inner_t *)eblock[i];
-        e->sub = (1 << i);
+        e->sub = ((eos_sub_t)1 << i);
         TEST_ASSERT_EQUAL_UINT8(0, heap.empty);
 
         print_heap_list(&heap, i);
@@ -54,11 +60,11 @@ void eos_test_heap(void)
     for (int i = 0; i < EOS_MAX_ACTORS; i ++) {
         TEST_ASSERT_EQUAL_UINT8(count, heap.count);
         eos_event_inner_t *e = (eos_event_inner_t *)eblock[i];
-        TEST_ASSERT_BIT_HIGH(i, e->sub);
+        TEST_ASSERT_EQUAL_UINT8(1, (e->sub >> i) & 1);
         eb = eos_heap_get_block(&heap, i);
         TEST_ASSERT_NOT_NULL(eb);
         TEST_ASSERT_EQUAL_POINTER(eblock[i], eb);
-        TEST_ASSERT_BIT_LOW(i, e->sub);
+        TEST_ASSERT_EQUAL_UINT8(0, (e->sub >> i) & 1);
         eos_heap_gc(&heap, e);
         count --;
         TEST_ASSERT_EQUAL_UINT8(count, heap.count);
@@ -76,7 +82,7 @@ void eos_test_heap(void)
         p_data = eos_heap_malloc(&heap, size);
         eos_event_inner_t *e = (eos_event_inner_t *)p_data;
         eos_u8_t priority = (size % EOS_MAX_ACTORS);
-        e->sub = (1 << priority);
+        e->sub = ((eos_sub_t)1 << priority);
         eos_event_inner_t *e_block = (eos_event_inner_t *)eos_heap_get_block(&heap, priority);
         TEST_ASSERT_EQUAL_POINTER(e, e_block);
         TEST_ASSERT_EQUAL_UINT32(0, heap.error_id);
@@ -143,6 +149,7 @@ void eos_test_heap(void)
 
     block_1st = (eos_block_t *)heap.data;
     TEST_ASSERT_EQUAL_UINT16(EOS_HEAP_MAX, heap.queue);
+    TEST_ASSERT_EQUAL_UINT16(EOS_HEAP_MAX, heap.tail);
     TEST_ASSERT_EQUAL_UINT8(1, heap.empty);
     TEST_ASSERT_EQUAL_UINT16(EOS_HEAP_MAX, block_1st->next);
     TEST_ASSERT_EQUAL_UINT16((EOS_SIZE_HEAP - sizeof(eos_block_t)), block_1st->size);
@@ -201,12 +208,136 @@ void eos_test_heap(void)
 
     block_1st = (eos_block_t *)heap.data;
     TEST_ASSERT_EQUAL_UINT16(EOS_HEAP_MAX, heap.queue);
+    TEST_ASSERT_EQUAL_UINT16(EOS_HEAP_MAX, heap.tail);
     TEST_ASSERT_EQUAL_UINT8(1, heap.empty);
     TEST_ASSERT_EQUAL_UINT16(EOS_HEAP_MAX, block_1st->next);
     TEST_ASSERT_EQUAL_UINT16((EOS_SIZE_HEAP - sizeof(eos_block_t)), block_1st->size);
     TEST_ASSERT_EQUAL_UINT16(0, heap.count);
 }
 
+/* 混合大小的随机申请与释放，大部分为0, 4, 8, 16, 64字节的事件数据，少量为大块数据。
+   返回过程中空闲块数量的最大值，用于衡量碎片化程度。 */
+#define HEAP_STRESS_LIVE_MAX                    64
+eos_u32_t heap_stress(eos_heap_t * const me, eos_u32_t times, eos_u32_t seed)
+{
+    static const eos_u32_t size_data[] = { 0, 4, 8, 16, 64, 0, 4, 8, 16, 64, 0, 0, 4, 16 };
+    eos_event_inner_t * live[HEAP_STRESS_LIVE_MAX];
+    eos_u32_t live_size[HEAP_STRESS_LIVE_MAX];
+    eos_u32_t live_count = 0;
+    eos_u32_t free_max = 0;
+    eos_u32_t rand_value = seed;
+
+    for (eos_u32_t i = 0; i < times; i ++) {
+        rand_value = rand_value * 1103515245 + 12345;
+        eos_u32_t r = (rand_value >> 8);
+        if (live_count < HEAP_STRESS_LIVE_MAX && ((r & 1) == 0 || live_count == 0)) {
+            eos_u32_t size = size_data[(r >> 1) % (sizeof(size_data) / sizeof(eos_u32_t))];
+            if (((r >> 5) % 16) == 0) {
+                size = 100 + ((r >> 9) % 300);
+            }
+            eos_event_inner_t *e = eos_heap_malloc(me, size + sizeof(eos_event_inner_t));
+            TEST_ASSERT_NOT_NULL(e);
+            TEST_ASSERT_EQUAL_UINT32(0, me->error_id);
+            e->sub = 0;
+            e->topic = (eos_topic_t)i;
+            eos_block_t *block = (eos_block_t *)((eos_pointer_t)e - sizeof(eos_block_t));
+            TEST_ASSERT_EQUAL_UINT32(size, block->size - block->offset - sizeof(eos_event_inner_t));
+            memset((eos_u8_t *)e + sizeof(eos_event_inner_t), (eos_u8_t)i, size);
+            live[live_count] = e;
+            live_size[live_count] = size;
+            live_count ++;
+        }
+        else {
+            eos_u32_t k = (r >> 1) % live_count;
+            eos_event_inner_t *e = live[k];
+            eos_u8_t *data = (eos_u8_t *)e + sizeof(eos_event_inner_t);
+            for (eos_u32_t j = 0; j < live_size[k]; j ++) {
+                TEST_ASSERT_EQUAL_UINT8((eos_u8_t)e->topic, data[j]);
+            }
+            eos_heap_gc(me, e);
+            TEST_ASSERT_EQUAL_UINT32(0, me->error_id);
+            live_count --;
+            live[k] = live[live_count];
+            live_size[k] = live_size[live_count];
+        }
+        TEST_ASSERT_EQUAL_UINT32(live_count, me->count);
+
+        eos_u32_t free_count = 0;
+        eos_u16_t next = 0;
+        do {
+            eos_block_t *block = (eos_block_t *)(me->data + next);
+            free_count += block->free;
+            next = block->next;
+        } while (next != EOS_HEAP_MAX);
+        free_max = (free_count > free_max) ? free_count : free_max;
+    }
+
+    while (live_count > 0) {
+        live_count --;
+        eos_heap_gc(me, live[live_count]);
+    }
+
+    return free_max;
+}
+
+void eos_test_heap_bin(void)
+{
+#if (EOS_USE_HEAP_BIN != 0)
+    eos_block_t * block_1st = (eos_block_t *)heap.data;
+
+    eos_heap_init_bin(&heap);
+
+    // 同一级别的小块内存，释放后被直接复用
+    eos_event_inner_t *e = eos_heap_malloc(&heap, sizeof(eos_event_inner_t) + 3);
+    eos_event_inner_t *e2 = eos_heap_malloc(&heap, sizeof(eos_event_inner_t) + 40);
+    e->sub = 0;
+    e2->sub = 0;
+    eos_heap_gc(&heap, e);
+    TEST_ASSERT_EQUAL_UINT16(1, heap.count);
+    TEST_ASSERT_EQUAL_UINT8(0, block_1st->free);
+    TEST_ASSERT_EQUAL_POINTER(e, eos_heap_malloc(&heap, sizeof(eos_event_inner_t) + 4));
+    eos_block_t *block = (eos_block_t *)((eos_pointer_t)e - sizeof(eos_block_t));
+    TEST_ASSERT_EQUAL_UINT32(4, block->size - block->offset - sizeof(eos_event_inner_t));
+    eos_heap_gc(&heap, e);
+    eos_heap_gc(&heap, e2);
+    eos_heap_bin_flush(&heap);
+    TEST_ASSERT_EQUAL_UINT16(EOS_HEAP_MAX, block_1st->next);
+    TEST_ASSERT_EQUAL_UINT16((EOS_SIZE_HEAP - sizeof(eos_block_t)), block_1st->size);
+
+    // 压力测试
+    eos_u32_t free_max = heap_stress(&heap, 100000, 1);
+    printf("heap stress, bin enabled, max free blocks: %u.\n", free_max);
+    eos_heap_bin_flush(&heap);
+    TEST_ASSERT_EQUAL_UINT16(EOS_HEAP_MAX, heap.queue);
+    TEST_ASSERT_EQUAL_UINT16(0, heap.count);
+    TEST_ASSERT_EQUAL_UINT16(EOS_HEAP_MAX, block_1st->next);
+    TEST_ASSERT_EQUAL_UINT16((EOS_SIZE_HEAP - sizeof(eos_block_t)), block_1st->size);
+
+    // 内存用尽时，空闲链表中的内存被归还
+    while (eos_heap_malloc(&heap, sizeof(eos_event_inner_t)) != EOS_NULL);
+    TEST_ASSERT_EQUAL_UINT32(2, heap.error_id);
+    while (heap.queue != EOS_HEAP_MAX) {
+        e = (eos_event_inner_t *)(heap.data + heap.queue + sizeof(eos_block_t));
+        e->sub = 0;
+        eos_heap_gc(&heap, e);
+    }
+    TEST_ASSERT_EQUAL_UINT8(0, block_1st->free);
+    e = eos_heap_malloc(&heap, EOS_SIZE_HEAP / 2);
+    TEST_ASSERT_NOT_NULL(e);
+    e->sub = 0;
+    eos_heap_gc(&heap, e);
+    eos_heap_bin_flush(&heap);
+    TEST_ASSERT_EQUAL_UINT16(EOS_HEAP_MAX, block_1st->next);
+    TEST_ASSERT_EQUAL_UINT16((EOS_SIZE_HEAP - sizeof(eos_block_t)), block_1st->size);
+#endif
+
+    eos_heap_init(&heap);
+    eos_u32_t free_max_plain = heap_stress(&heap, 100000, 1);
+    printf("heap stress, bin disabled, max free blocks: %u.\n", free_max_plain);
+    TEST_ASSERT_EQUAL_UINT16(EOS_HEAP_MAX, heap.queue);
+    TEST_ASSERT_EQUAL_UINT16(0, heap.count);
+}
+
 static void print_heap_list(eos_heap_t * const me, eos_u32_t index)
 {
 #if (EOS_HEAP_TEST_PRINT_EN == 0)
@@ -0,0 +1,709 @@
+/* include ------------------------------------------------------------------ */
+#include "eos_test.h"
+#include "eventos.h"
+#include "unity.h"
+#include "eos_test_def.h"
+#include <string.h>
+
+#if (EOS_USE_HSM_MODE != 0 && EOS_USE_PUB_SUB != 0)
+/* unittest ----------------------------------------------------------------- */
+// 测试用的层次状态机，覆盖各种源状态与目标状态的关系：
+// top
+// └── s
+//     ├── s1
+//     │   └── s11
+//     └── s2
+//         └── s21
+//             └── s211
+enum {
+    Hsm_A = Event_User,
+    Hsm_B,
+    Hsm_C,
+    Hsm_D,
+    Hsm_E,
+    Hsm_F,
+    Hsm_G,
+    Hsm_H,
+    Hsm_I,
+
+    Hsm_Max
+};
+
+typedef struct hsm_test {
+    eos_sm_t super;
+    eos_bool_t foo;
+} hsm_test_t;
+
+static hsm_test_t hsm;
+static char log_buffer[256];
+static eos_u32_t count_null;
+
+typedef struct hsm_step {
+    eos_topic_t topic;
+    const char *expected;
+} hsm_step_t;
+
+static eos_ret_t state_init(hsm_test_t * const me, eos_event_t const * const e);
+static eos_ret_t state_s(hsm_test_t * const me, eos_event_t const * const e);
+static eos_ret_t state_s1(hsm_test_t * const me, eos_event_t const * const e);
+static eos_ret_t state_s11(hsm_test_t * const me, eos_event_t const * const e);
+static eos_ret_t state_s2(hsm_test_t * const me, eos_event_t const * const e);
+static eos_ret_t state_s21(hsm_test_t * const me, eos_event_t const * const e);
+static eos_ret_t state_s211(hsm_test_t * const me, eos_event_t const * const e);
+
+static void hsm_log(const char *name, eos_event_t const * const e)
+{
+    const char *action = EOS_NULL;
+
+    if (e->topic == Event_Enter) {
+        action = "-ENTRY;";
+    }
+    else if (e->topic == Event_Exit) {
+        action = "-EXIT;";
+    }
+    else if (e->topic == Event_Null) {
+        count_null ++;
+    }
+    else if (e->topic != Event_Init) {
+        static char name_event[] = "-A;";
+        name_event[1] = (char)('A' + e->topic - Hsm_A);
+        action = name_event;
+    }
+    if (action != EOS_NULL) {
+        strcat(log_buffer, name);
+        strcat(log_buffer, action);
+    }
+}
+
+static eos_ret_t state_init(hsm_test_t * const me, eos_event_t const * const e)
+{
+    (void)e;
+
+    me->foo = EOS_False;
+    for (eos_topic_t topic = Hsm_A; topic < Hsm_Max; topic ++) {
+        EOS_EVENT_SUB(topic);
+    }
+    strcat(log_buffer, "top-INIT;");
+
+    return EOS_TRAN(state_s2);
+}
+
+static eos_ret_t state_s(hsm_test_t * const me, eos_event_t const * const e)
+{
+    hsm_log("s", e);
+    switch (e->topic) {
+        case Event_Enter:
+        case Event_Exit:
+            return EOS_Ret_Handled;
+
+        case Event_Init:
+            strcat(log_buffer, "s-INIT;");
+            return EOS_TRAN(state_s11);
+
+        case Hsm_E:
+            return EOS_TRAN(state_s11);
+
+        case Hsm_I:
+            if (me->foo == EOS_True) {
+                me->foo = EOS_False;
+                return EOS_Ret_Handled;
+            }
+            break;
+    }
+
+    return EOS_SUPER(eos_state_top);
+}
+
+static eos_ret_t state_s1(hsm_test_t * const me, eos_event_t const * const e)
+{
+    hsm_log("s1", e);
+    switch (e->topic) {
+        case Event_Enter:
+        case Event_Exit:
+        case Hsm_I:
+            return EOS_Ret_Handled;
+
+        case Event_Init:
+            strcat(log_buffer, "s1-INIT;");
+            return EOS_TRAN(state_s11);
+
+        case Hsm_A:
+            return EOS_TRAN(state_s1);
+
+        case Hsm_B:
+            return EOS_TRAN(state_s11);
+
+        case Hsm_C:
+            return EOS_TRAN(state_s2);
+
+        case Hsm_D:
+            if (me->foo == EOS_False) {
+                me->foo = EOS_True;
+                return EOS_TRAN(state_s);
+            }
+            break;
+
+        case Hsm_F:
+            return EOS_TRAN(state_s211);
+    }
+
+    return EOS_SUPER(state_s);
+}
+
+static eos_ret_t state_s11(hsm_test_t * const me, eos_event_t const * const e)
+{
+    hsm_log("s11", e);
+    switch (e->topic) {
+        case Event_Enter:
+        case Event_Exit:
+            return EOS_Ret_Handled;
+
+        case Hsm_D:
+            if (me->foo == EOS_True) {
+                me->foo = EOS_False;
+                return EOS_TRAN(state_s1);
+            }
+            break;
+
+        case Hsm_G:
+            return EOS_TRAN(state_s211);
+
+        case Hsm_H:
+            return EOS_TRAN(state_s);
+    }
+
+    return EOS_SUPER(state_s1);
+}
+
+static eos_ret_t state_s2(hsm_test_t * const me, eos_event_t const * const e)
+{
+    hsm_log("s2", e);
+    switch (e->topic) {
+        case Event_Enter:
+        case Event_Exit:
+            return EOS_Ret_Handled;
+
+        case Event_Init:
+            strcat(log_buffer, "s2-INIT;");
+            return EOS_TRAN(state_s211);
+
+        case Hsm_C:
+            return EOS_TRAN(state_s1);
+
+        case Hsm_F:
+            return EOS_TRAN(state_s11);
+
+        case Hsm_I:
+            if (me->foo == EOS_False) {
+                me->foo = EOS_True;
+                return EOS_Ret_Handled;
+            }
+            break;
+    }
+
+    return EOS_SUPER(state_s);
+}
+
+static eos_ret_t state_s21(hsm_test_t * const me, eos_event_t const * const e)
+{
+    hsm_log("s21", e);
+    switch (e->topic) {
+        case Event_Enter:
+        case Event_Exit:
+            return EOS_Ret_Handled;
+
+        case Event_Init:
+            strcat(log_buffer, "s21-INIT;");
+            return EOS_TRAN(state_s211);
+
+        case Hsm_A:
+            return EOS_TRAN(state_s21);
+
+        case Hsm_B:
+            return EOS_TRAN(state_s211);
+
+        case Hsm_G:
+            return EOS_TRAN(state_s1);
+    }
+
+    return EOS_SUPER(state_s2);
+}
+
+static eos_ret_t state_s211(hsm_test_t * const me, eos_event_t const * const e)
+{
+    // 不处理进入与退出，返回父状态
+    hsm_log("s211", e);
+    switch (e->topic) {
+        case Hsm_D:
+            return EOS_TRAN(state_s21);
+
+        case Hsm_H:
+            return EOS_TRAN(state_s);
+    }
+
+    return EOS_SUPER(state_s21);
+}
+
+// 依次发布的事件，及引起的处理、进入、退出与初始化
+static const hsm_step_t hsm_steps[] = {
+    { Hsm_A, "s211-A;s21-A;s211-EXIT;s21-EXIT;s21-ENTRY;s21-INIT;s211-ENTRY;" },
+    { Hsm_B, "s211-B;s21-B;s211-EXIT;s211-ENTRY;" },
+    { Hsm_D, "s211-D;s211-EXIT;s21-INIT;s211-ENTRY;" },
+    { Hsm_C, "s211-C;s21-C;s2-C;s211-EXIT;s21-EXIT;s2-EXIT;s1-ENTRY;s1-INIT;s11-ENTRY;" },
+    { Hsm_E, "s11-E;s1-E;s-E;s11-EXIT;s1-EXIT;s1-ENTRY;s11-ENTRY;" },
+    { Hsm_G, "s11-G;s11-EXIT;s1-EXIT;s2-ENTRY;s21-ENTRY;s211-ENTRY;" },
+    { Hsm_I, "s211-I;s21-I;s2-I;" },
+    { Hsm_I, "s211-I;s21-I;s2-I;s-I;" },
+    { Hsm_F, "s211-F;s21-F;s2-F;s211-EXIT;s21-EXIT;s2-EXIT;s1-ENTRY;s11-ENTRY;" },
+    { Hsm_I, "s11-I;s1-I;" },
+    { Hsm_F, "s11-F;s1-F;s11-EXIT;s1-EXIT;s2-ENTRY;s21-ENTRY;s211-ENTRY;" },
+    { Hsm_A, "s211-A;s21-A;s211-EXIT;s21-EXIT;s21-ENTRY;s21-INIT;s211-ENTRY;" },
+    { Hsm_C, "s211-C;s21-C;s2-C;s211-EXIT;s21-EXIT;s2-EXIT;s1-ENTRY;s1-INIT;s11-ENTRY;" },
+    { Hsm_D, "s11-D;s1-D;s11-EXIT;s1-EXIT;s-INIT;s1-ENTRY;s11-ENTRY;" },
+    { Hsm_D, "s11-D;s11-EXIT;s1-INIT;s11-ENTRY;" },
+    { Hsm_A, "s11-A;s1-A;s11-EXIT;s1-EXIT;s1-ENTRY;s1-INIT;s11-ENTRY;" },
+    { Hsm_B, "s11-B;s1-B;s11-EXIT;s11-ENTRY;" },
+    { Hsm_C, "s11-C;s1-C;s11-EXIT;s1-EXIT;s2-ENTRY;s2-INIT;s21-ENTRY;s211-ENTRY;" },
+    { Hsm_E, "s211-E;s21-E;s2-E;s-E;s211-EXIT;s21-EXIT;s2-EXIT;s1-ENTRY;s11-ENTRY;" },
+    { Hsm_H, "s11-H;s11-EXIT;s1-EXIT;s-INIT;s1-ENTRY;s11-ENTRY;" },
+    { Hsm_G, "s11-G;s11-EXIT;s1-EXIT;s2-ENTRY;s21-ENTRY;s211-ENTRY;" },
+    { Hsm_H, "s211-H;s211-EXIT;s21-EXIT;s2-EXIT;s-INIT;s1-ENTRY;s11-ENTRY;" },
+};
+
+// 发布事件并分发，对比各状态的记录
+static void hsm_run_steps(void)
+{
+    for (eos_u32_t i = 0; i < sizeof(hsm_steps) / sizeof(hsm_step_t); i ++) {
+        log_buffer[0] = 0;
+        TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(hsm_steps[i].topic, EOS_NULL, 0));
+        while (eos_once() == EosRun_OK);
+        TEST_ASSERT_EQUAL_STRING(hsm_steps[i].expected, log_buffer);
+    }
+    TEST_ASSERT(hsm.super.state == EOS_STATE_CAST(state_s11));
+}
+
+static void hsm_start(void)
+{
+    (void)eos_test_setup(Hsm_Max);
+    log_buffer[0] = 0;
+    eos_test_sm_start(&hsm.super, EOS_STATE_CAST(state_init));
+    TEST_ASSERT_EQUAL_STRING(
+        "top-INIT;s-ENTRY;s2-ENTRY;s2-INIT;s21-ENTRY;s211-ENTRY;", log_buffer);
+    TEST_ASSERT(hsm.super.state == EOS_STATE_CAST(state_s211));
+}
+#endif
+
+void eos_test_hsm(void)
+{
+#if (EOS_USE_HSM_MODE != 0 && EOS_USE_PUB_SUB != 0)
+    hsm_start();
+    hsm_run_steps();
+
+#if (EOS_USE_HSM_CACHE != 0)
+    // 各状态都已缓存，重新启动后的转换不再调用状态函数探测父状态 --------------
+    eos_t *f = eos_get_framework();
+    TEST_ASSERT_EQUAL_UINT16(7, f->hsm_count);
+    count_null = 0;
+    eos_sm_start(&hsm.super, EOS_STATE_CAST(state_init));
+    hsm_run_steps();
+    TEST_ASSERT_EQUAL_UINT32(0, count_null);
+#if (EOS_USE_HSM_TRAN_CACHE != 0 && EOS_SIZE_HSM_TRAN_PATH >= 2)
+    // 转换缓存已满，两遍之中替换过的转换，结果都与计算的相同。最后一个事件中s的初始转换
+    // 仍在缓存中，由s之下进入s1、s11。
+    TEST_ASSERT_EQUAL_UINT8(EOS_SIZE_HSM_TRAN_CACHE, hsm.super.tran_count);
+    eos_sm_tran_t *tran = EOS_NULL;
+    for (eos_u8_t i = 0; i < hsm.super.tran_count; i ++) {
+        if (hsm.super.tran[i].source == EOS_STATE_CAST(state_s) &&
+            hsm.super.tran[i].target == EOS_STATE_CAST(state_s11)) {
+            tran = &hsm.super.tran[i];
+        }
+    }
+    TEST_ASSERT_NOT_NULL(tran);
+    TEST_ASSERT(tran->lca == EOS_STATE_CAST(state_s));
+    TEST_ASSERT_EQUAL_UINT8(2, tran->enter_num);
+    TEST_ASSERT(tran->enter[0] == EOS_STATE_CAST(state_s1));
+    TEST_ASSERT(tran->enter[1] == EOS_STATE_CAST(state_s11));
+#endif
+    // 重新初始化后缓存清空，再次探测的结果相同
+    hsm_start();
+    TEST_ASSERT_EQUAL_UINT16(5, f->hsm_count);
+    hsm_run_steps();
+    TEST_ASSERT_EQUAL_UINT16(7, f->hsm_count);
+#endif
+#endif
+}
+
+#if (EOS_USE_HSM_MODE != 0 && EOS_MAX_HSM_NEST_DEPTH >= 8 && EOS_USE_PUB_SUB != 0)
+/* deep hierarchy ----------------------------------------------------------- */
+// 两个8层的分支，共用第1层的状态d1：
+// top
+// └── d1
+//     ├── a2 ── a3 ── ... ── a8
+//     └── b2 ── b3 ── ... ── b8
+enum {
+    Deep_Cross = Event_User,                    // a8与b8之间互相转换
+    Deep_Self,                                  // a8转换到自身
+    Deep_Up,                                    // a8转换到祖先d1，再钻入a8
+    Deep_Parent,                                // a8转换到父状态a7，再钻入a8
+    Deep_Middle,                                // d1处理，转换到a4
+    Deep_Side,                                  // a8转换到b6，b6再转换回a8
+
+    Deep_Max
+};
+
+static eos_sm_t deep;
+static eos_pointer_t stack_low;
+
+static eos_ret_t deep_a4(eos_sm_t * const me, eos_event_t const * const e);
+static eos_ret_t deep_a8(eos_sm_t * const me, eos_event_t const * const e);
+static eos_ret_t deep_b8(eos_sm_t * const me, eos_event_t const * const e);
+static eos_ret_t deep_b6(eos_sm_t * const me, eos_event_t const * const e);
+
+// 记录进入与退出，以及状态函数中栈的最低位置
+static eos_ret_t deep_state(eos_sm_t * const me, eos_event_t const * const e,
+                            const char *name, eos_state_handler super)
+{
+    eos_u8_t mark;
+    if ((eos_pointer_t)&mark < stack_low) {
+        stack_low = (eos_pointer_t)&mark;
+    }
+
+    if (e->topic == Event_Enter || e->topic == Event_Exit) {
+        strcat(log_buffer, (e->topic == Event_Enter) ? "+" : "-");
+        strcat(log_buffer, name);
+        return EOS_Ret_Handled;
+    }
+
+    return EOS_SUPER(super);
+}
+
+#define DEEP_STATE(name_, super_)                                              \
+    static eos_ret_t deep_##name_(eos_sm_t * const me, eos_event_t const * const e) \
+    {                                                                          \
+        return deep_state(me, e, #name_, EOS_STATE_CAST(deep_##super_));       \
+    }
+
+static eos_ret_t deep_init(eos_sm_t * const me, eos_event_t const * const e)
+{
+    (void)e;
+
+    for (eos_topic_t topic = Deep_Cross; topic < Deep_Max; topic ++) {
+        eos_event_sub(&me->super, topic);
+    }
+
+    return EOS_TRAN(deep_a8);
+}
+
+static eos_ret_t deep_d1(eos_sm_t * const me, eos_event_t const * const e)
+{
+    if (e->topic == Event_Init) {
+        return EOS_TRAN(deep_a8);
+    }
+    if (e->topic == Deep_Middle) {
+        return EOS_TRAN(deep_a4);
+    }
+
+    return deep_state(me, e, "d1", EOS_STATE_CAST(eos_state_top));
+}
+
+DEEP_STATE(a2, d1)
+DEEP_STATE(a3, a2)
+DEEP_STATE(a4, a3)
+DEEP_STATE(a5, a4)
+DEEP_STATE(a6, a5)
+DEEP_STATE(b2, d1)
+DEEP_STATE(b3, b2)
+DEEP_STATE(b4, b3)
+DEEP_STATE(b5, b4)
+DEEP_STATE(b7, b6)
+
+static eos_ret_t deep_b6(eos_sm_t * const me, eos_event_t const * const e)
+{
+    if (e->topic == Deep_Side) {
+        return EOS_TRAN(deep_a8);
+    }
+
+    return deep_state(me, e, "b6", EOS_STATE_CAST(deep_b5));
+}
+
+static eos_ret_t deep_a7(eos_sm_t * const me, eos_event_t const * const e)
+{
+    if (e->topic == Event_Init) {
+        return EOS_TRAN(deep_a8);
+    }
+
+    return deep_state(me, e, "a7", EOS_STATE_CAST(deep_a6));
+}
+
+static eos_ret_t deep_a8(eos_sm_t * const me, eos_event_t const * const e)
+{
+    switch (e->topic) {
+        case Deep_Cross:
+            return EOS_TRAN(deep_b8);
+
+        case Deep_Self:
+            return EOS_TRAN(deep_a8);
+
+        case Deep_Up:
+            return EOS_TRAN(deep_d1);
+
+        case Deep_Parent:
+            return EOS_TRAN(deep_a7);
+
+        case Deep_Side:
+            return EOS_TRAN(deep_b6);
+    }
+
+    return deep_state(me, e, "a8", EOS_STATE_CAST(deep_a7));
+}
+
+static eos_ret_t deep_b8(eos_sm_t * const me, eos_event_t const * const e)
+{
+    if (e->topic == Deep_Cross) {
+        return EOS_TRAN(deep_a8);
+    }
+
+    return deep_state(me, e, "b8", EOS_STATE_CAST(deep_b7));
+}
+
+// 发布并分发一个事件，返回分发中栈的最大占用
+static eos_u32_t deep_check(eos_topic_t topic, const char *expected)
+{
+    eos_u8_t base;
+
+    log_buffer[0] = 0;
+    stack_low = (eos_pointer_t)&base;
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(topic, EOS_NULL, 0));
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_STRING(expected, log_buffer);
+
+    return (eos_u32_t)((eos_pointer_t)&base - stack_low);
+}
+#endif
+
+void eos_test_hsm_deep(void)
+{
+#if (EOS_USE_HSM_MODE != 0 && EOS_MAX_HSM_NEST_DEPTH >= 8 && EOS_USE_PUB_SUB != 0)
+    (void)eos_test_setup(Deep_Max);
+    log_buffer[0] = 0;
+    eos_test_sm_start(&deep, EOS_STATE_CAST(deep_init));
+    TEST_ASSERT_EQUAL_STRING("+d1+a2+a3+a4+a5+a6+a7+a8", log_buffer);
+
+    eos_u32_t stack_self = 0, stack_cross = 0, stack_parent = 0, stack_up = 0, stack_side = 0;
+    for (eos_u32_t i = 0; i < 2; i ++) {
+        stack_cross = deep_check(Deep_Cross, "-a8-a7-a6-a5-a4-a3-a2+b2+b3+b4+b5+b6+b7+b8");
+        deep_check(Deep_Cross, "-b8-b7-b6-b5-b4-b3-b2+a2+a3+a4+a5+a6+a7+a8");
+        stack_self = deep_check(Deep_Self, "-a8+a8");
+        // 转换到祖先时不退出祖先，之后钻入7层
+        stack_up = deep_check(Deep_Up, "-a8-a7-a6-a5-a4-a3-a2+a2+a3+a4+a5+a6+a7+a8");
+        stack_parent = deep_check(Deep_Parent, "-a8+a8");
+        stack_side = deep_check(Deep_Side, "-a8-a7-a6-a5-a4-a3-a2+b2+b3+b4+b5+b6");
+        deep_check(Deep_Side, "-b6-b5-b4-b3-b2+a2+a3+a4+a5+a6+a7+a8");
+    }
+    // 由d1处理的事件，先退出到d1，再进入a4
+    deep_check(Deep_Middle, "-a8-a7-a6-a5-a4-a3-a2+a2+a3+a4");
+    TEST_ASSERT(deep.state == EOS_STATE_CAST(deep_a4));
+    deep_check(Deep_Cross, "");
+    TEST_ASSERT(deep.state == EOS_STATE_CAST(deep_a4));
+
+#if (EOS_USE_HSM_TRAN_CACHE != 0)
+    // 转换缓存只保存进入不多于EOS_SIZE_HSM_TRAN_PATH层的转换，a8与b8之间的转换进入7层
+    for (eos_u8_t i = 0; i < deep.tran_count; i ++) {
+        TEST_ASSERT(deep.tran[i].enter_num <= EOS_SIZE_HSM_TRAN_PATH);
+#if (EOS_SIZE_HSM_TRAN_PATH < 7)
+        TEST_ASSERT(deep.tran[i].source != EOS_STATE_CAST(deep_a8) ||
+                    deep.tran[i].target != EOS_STATE_CAST(deep_b8));
+#endif
+    }
+#endif
+
+    // 状态都已缓存后，同一类转换中栈的占用与退出、进入的层数无关
+#if (EOS_USE_HSM_CACHE != 0 && (EOS_USE_HSM_TRAN_CACHE == 0 || EOS_SIZE_HSM_TRAN_PATH >= 7))
+    TEST_ASSERT_UINT32_WITHIN(16, stack_self, stack_cross);
+    TEST_ASSERT_UINT32_WITHIN(16, stack_parent, stack_up);
+#endif
+    // 未缓存的转换逐层进入，进入5层与7层时栈的占用相同
+#if (EOS_USE_HSM_CACHE != 0 && EOS_USE_HSM_TRAN_CACHE != 0 && EOS_SIZE_HSM_TRAN_PATH < 5)
+    TEST_ASSERT_UINT32_WITHIN(16, stack_side, stack_cross);
+#endif
+    (void)stack_self;
+    (void)stack_cross;
+    (void)stack_parent;
+    (void)stack_up;
+    (void)stack_side;
+#endif
+}
+
+#if (EOS_USE_HSM_HISTORY != 0 && EOS_USE_PUB_SUB != 0)
+/* history ------------------------------------------------------------------ */
+// top
+// ├── idle
+// └── mode（记录历史）
+//     ├── m1（记录历史）
+//     │   ├── m11
+//     │   └── m12
+//     └── m2
+enum {
+    Hist_Next = Event_User,                     // m11 -> m12 -> m2 -> m1
+    Hist_Off,                                   // mode处理，转换到idle
+    Hist_Default,                               // idle转换到mode
+    Hist_Shallow,                               // idle转换到mode的浅历史
+    Hist_Deep,                                  // idle转换到mode的深历史
+
+    Hist_Max
+};
+
+static eos_sm_t hist;
+
+static eos_ret_t hist_idle(eos_sm_t * const me, eos_event_t const * const e);
+static eos_ret_t hist_mode(eos_sm_t * const me, eos_event_t const * const e);
+static eos_ret_t hist_m1(eos_sm_t * const me, eos_event_t const * const e);
+static eos_ret_t hist_m11(eos_sm_t * const me, eos_event_t const * const e);
+static eos_ret_t hist_m12(eos_sm_t * const me, eos_event_t const * const e);
+static eos_ret_t hist_m2(eos_sm_t * const me, eos_event_t const * const e);
+
+// 记录进入、退出与初始转换，未处理的事件交给父状态
+static eos_ret_t hist_state(eos_sm_t * const me, eos_event_t const * const e,
+                            const char *name, eos_state_handler super)
+{
+    if (e->topic == Event_Enter || e->topic == Event_Exit) {
+        strcat(log_buffer, (e->topic == Event_Enter) ? "+" : "-");
+        strcat(log_buffer, name);
+        return EOS_Ret_Handled;
+    }
+
+    return EOS_SUPER(super);
+}
+
+static eos_ret_t hist_init(eos_sm_t * const me, eos_event_t const * const e)
+{
+    (void)e;
+
+    for (eos_topic_t topic = Hist_Next; topic < Hist_Max; topic ++) {
+        eos_event_sub(&me->super, topic);
+    }
+    EOS_HISTORY(hist_mode);
+    EOS_HISTORY(hist_m1);
+
+    return EOS_TRAN(hist_idle);
+}
+
+static eos_ret_t hist_idle(eos_sm_t * const me, eos_event_t const * const e)
+{
+    switch (e->topic) {
+        case Hist_Default:
+            return EOS_TRAN(hist_mode);
+
+        case Hist_Shallow:
+            return EOS_TRAN_HISTORY(hist_mode);
+
+        case Hist_Deep:
+            return EOS_TRAN_DEEP_HISTORY(hist_mode);
+    }
+
+    return hist_state(me, e, "idle", EOS_STATE_CAST(eos_state_top));
+}
+
+static eos_ret_t hist_mode(eos_sm_t * const me, eos_event_t const * const e)
+{
+    switch (e->topic) {
+        case Event_Init:
+            strcat(log_buffer, "*mode");
+            return EOS_TRAN(hist_m1);
+
+        case Hist_Off:
+            return EOS_TRAN(hist_idle);
+    }
+
+    return hist_state(me, e, "mode", EOS_STATE_CAST(eos_state_top));
+}
+
+static eos_ret_t hist_m1(eos_sm_t * const me, eos_event_t const * const e)
+{
+    if (e->topic == Event_Init) {
+        strcat(log_buffer, "*m1");
+        return EOS_TRAN(hist_m11);
+    }
+
+    return hist_state(me, e, "m1", EOS_STATE_CAST(hist_mode));
+}
+
+static eos_ret_t hist_m11(eos_sm_t * const me, eos_event_t const * const e)
+{
+    if (e->topic == Hist_Next) {
+        return EOS_TRAN(hist_m12);
+    }
+
+    return hist_state(me, e, "m11", EOS_STATE_CAST(hist_m1));
+}
+
+static eos_ret_t hist_m12(eos_sm_t * const me, eos_event_t const * const e)
+{
+    if (e->topic == Hist_Next) {
+        return EOS_TRAN(hist_m2);
+    }
+
+    return hist_state(me, e, "m12", EOS_STATE_CAST(hist_m1));
+}
+
+static eos_ret_t hist_m2(eos_sm_t * const me, eos_event_t const * const e)
+{
+    if (e->topic == Hist_Next) {
+        return EOS_TRAN(hist_m1);
+    }
+
+    return hist_state(me, e, "m2", EOS_STATE_CAST(hist_mode));
+}
+
+static void hist_check(eos_topic_t topic, const char *expected, eos_state_handler state)
+{
+    log_buffer[0] = 0;
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(topic, EOS_NULL, 0));
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_STRING(expected, log_buffer);
+    TEST_ASSERT(hist.state == state);
+}
+#endif
+
+void eos_test_hsm_history(void)
+{
+#if (EOS_USE_HSM_HISTORY != 0 && EOS_USE_PUB_SUB != 0)
+    (void)eos_test_setup(Hist_Max);
+    log_buffer[0] = 0;
+    hist.super.enabled = EOS_False;
+    eos_sm_init(&hist, 0, EOS_NULL);
+    TEST_ASSERT_EQUAL_UINT8(0, hist.history_count);
+    eos_sm_start(&hist, EOS_STATE_CAST(hist_init));
+    TEST_ASSERT_EQUAL_STRING("+idle", log_buffer);
+    TEST_ASSERT_EQUAL_UINT8(2, hist.history_count);
+
+    // 尚未退出过时，转换到历史与转换到该状态相同 --------------------------------
+    hist_check(Hist_Deep, "-idle+mode*mode+m1*m1+m11", EOS_STATE_CAST(hist_m11));
+    hist_check(Hist_Next, "-m11+m12", EOS_STATE_CAST(hist_m12));
+    hist_check(Hist_Off, "-m12-m1-mode+idle", EOS_STATE_CAST(hist_idle));
+
+    // 深历史直接进入叶状态，不再执行各层的初始转换 ------------------------------
+    hist_check(Hist_Deep, "-idle+mode+m1+m12", EOS_STATE_CAST(hist_m12));
+    hist_check(Hist_Off, "-m12-m1-mode+idle", EOS_STATE_CAST(hist_idle));
+    // 浅历史进入直接子状态，再执行其初始转换
+    hist_check(Hist_Shallow, "-idle+mode+m1*m1+m11", EOS_STATE_CAST(hist_m11));
+    hist_check(Hist_Next, "-m11+m12", EOS_STATE_CAST(hist_m12));
+    hist_check(Hist_Next, "-m12-m1+m2", EOS_STATE_CAST(hist_m2));
+    hist_check(Hist_Off, "-m2-mode+idle", EOS_STATE_CAST(hist_idle));
+    hist_check(Hist_Deep, "-idle+mode+m2", EOS_STATE_CAST(hist_m2));
+    hist_check(Hist_Off, "-m2-mode+idle", EOS_STATE_CAST(hist_idle));
+    hist_check(Hist_Shallow, "-idle+mode+m2", EOS_STATE_CAST(hist_m2));
+
+    // 在组合状态内部的转换也记下历史；普通转换不受历史影响 ----------------------
+    TEST_ASSERT(hist.history[1].deep == EOS_STATE_CAST(hist_m12));
+    hist_check(Hist_Next, "-m2+m1*m1+m11", EOS_STATE_CAST(hist_m11));
+    hist_check(Hist_Off, "-m11-m1-mode+idle", EOS_STATE_CAST(hist_idle));
+    hist_check(Hist_Default, "-idle+mode*mode+m1*m1+m11", EOS_STATE_CAST(hist_m11));
+    TEST_ASSERT(hist.history[0].shallow == EOS_STATE_CAST(hist_m1));
+    TEST_ASSERT(hist.history[0].deep == EOS_STATE_CAST(hist_m11));
+
+    // 重新初始化后清空历史 ------------------------------------------------------
+    eos_sm_init(&hist, 0, EOS_NULL);
+    TEST_ASSERT_EQUAL_UINT8(0, hist.history_count);
+#endif
+}
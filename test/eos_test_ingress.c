@@ -0,0 +1,157 @@
+/* include ------------------------------------------------------------------ */
+#include "eos_test.h"
+#include "eventos.h"
+#include "event_def.h"
+#include "unity.h"
+#include "eos_test_def.h"
+#include <pthread.h>
+#include <sched.h>
+
+#if (EOS_USE_PUB_INGRESS != 0)
+/* ingress function --------------------------------------------------------- */
+void eos_ingress_init(eos_ingress_t * const me);
+eos_bool_t eos_ingress_push(eos_ingress_t * const me, eos_topic_t topic);
+eos_bool_t eos_ingress_pop(eos_ingress_t * const me, eos_topic_t *topic);
+
+/* unittest ----------------------------------------------------------------- */
+#define INGRESS_TEST_PRODUCERS                  4
+#define INGRESS_TEST_TIMES                      50000
+
+static eos_reactor_t ingress_actor[2];
+static eos_topic_t log_topic[8];
+static eos_u32_t log_count;
+static eos_ingress_t ingress;
+static eos_t *f;
+
+static void ingress_handler(eos_reactor_t * const me, eos_event_t const * const e)
+{
+    (void)me;
+
+    if (log_count < 8) {
+        log_topic[log_count] = e->topic;
+    }
+    log_count ++;
+}
+
+// 每个生产者发布的主题为 编号 * 64 + 序号 % 64，用于检查同一生产者的先后顺序
+static void * ingress_producer(void *parameter)
+{
+    eos_u32_t id = (eos_u32_t)(eos_pointer_t)parameter;
+
+    for (eos_u32_t i = 0; i < INGRESS_TEST_TIMES; i ++) {
+        eos_topic_t topic = (eos_topic_t)(id * 64 + (i % 64));
+        // 队列已满时让出CPU，单核主机上消费者才能运行
+        while (eos_ingress_push(&ingress, topic) == EOS_False) {
+            sched_yield();
+        }
+    }
+
+    return EOS_NULL;
+}
+#endif
+
+void eos_test_ingress(void)
+{
+#if (EOS_USE_PUB_INGRESS != 0)
+    eos_topic_t topic;
+
+    // 单线程下的先进先出与满、空 ------------------------------------------------
+    eos_ingress_init(&ingress);
+    TEST_ASSERT_EQUAL_UINT8(EOS_False, eos_ingress_pop(&ingress, &topic));
+    for (eos_u32_t i = 0; i < EOS_SIZE_PUB_INGRESS; i ++) {
+        TEST_ASSERT_EQUAL_UINT8(EOS_True, eos_ingress_push(&ingress, (eos_topic_t)(i + 1)));
+    }
+    TEST_ASSERT_EQUAL_UINT8(EOS_False, eos_ingress_push(&ingress, 100));
+    for (eos_u32_t i = 0; i < EOS_SIZE_PUB_INGRESS; i ++) {
+        TEST_ASSERT_EQUAL_UINT8(EOS_True, eos_ingress_pop(&ingress, &topic));
+        TEST_ASSERT_EQUAL_UINT16(i + 1, topic);
+    }
+    TEST_ASSERT_EQUAL_UINT8(EOS_False, eos_ingress_pop(&ingress, &topic));
+
+    // 序号的16位回绕
+    for (eos_u32_t i = 0; i < 100000; i ++) {
+        TEST_ASSERT_EQUAL_UINT8(EOS_True, eos_ingress_push(&ingress, (eos_topic_t)(i & 0x7f)));
+        TEST_ASSERT_EQUAL_UINT8(EOS_True, eos_ingress_pop(&ingress, &topic));
+        TEST_ASSERT_EQUAL_UINT16((i & 0x7f), topic);
+    }
+    TEST_ASSERT_EQUAL_UINT8(EOS_False, eos_ingress_pop(&ingress, &topic));
+
+    // 多个生产者线程并发写入，消费者同时取出 ------------------------------------
+    pthread_t producer[INGRESS_TEST_PRODUCERS];
+    eos_u32_t next[INGRESS_TEST_PRODUCERS] = { 0 };
+    eos_u32_t count = 0;
+    for (eos_u32_t i = 0; i < INGRESS_TEST_PRODUCERS; i ++) {
+        pthread_create(&producer[i], EOS_NULL, ingress_producer, (void *)(eos_pointer_t)i);
+    }
+    while (count < (INGRESS_TEST_PRODUCERS * INGRESS_TEST_TIMES)) {
+        if (eos_ingress_pop(&ingress, &topic) == EOS_False) {
+            sched_yield();
+            continue;
+        }
+        eos_u32_t id = topic / 64;
+        TEST_ASSERT(id < INGRESS_TEST_PRODUCERS);
+        TEST_ASSERT_EQUAL_UINT32((next[id] % 64), (topic % 64));
+        next[id] ++;
+        count ++;
+    }
+    for (eos_u32_t i = 0; i < INGRESS_TEST_PRODUCERS; i ++) {
+        pthread_join(producer[i], EOS_NULL);
+        TEST_ASSERT_EQUAL_UINT32(INGRESS_TEST_TIMES, next[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT8(EOS_False, eos_ingress_pop(&ingress, &topic));
+
+    // 经入口环发布的事件，在调度时转入事件队列 ----------------------------------
+    f = eos_test_setup(Event_Max);
+    eos_test_reactors(ingress_actor, 2, ingress_handler);
+#if (EOS_USE_PUB_SUB != 0)
+    eos_event_sub(&ingress_actor[1].super, Event_Test);
+    eos_event_sub(&ingress_actor[0].super, Event_TestReactor);
+#endif
+    log_count = 0;
+
+    eos_event_pub_topic(Event_TestReactor);
+    eos_event_pub_topic(Event_Test);
+    TEST_ASSERT_EQUAL_UINT16(0, f->ring.count);
+    TEST_ASSERT_EQUAL_UINT32(0, f->sub_general);
+    TEST_ASSERT_EQUAL_UINT16(2, (eos_u16_t)(f->ingress.tail - f->ingress.head));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_UINT16(0, (eos_u16_t)(f->ingress.tail - f->ingress.head));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
+    TEST_ASSERT_EQUAL_UINT32(2, log_count);
+    TEST_ASSERT_EQUAL_UINT16(Event_Test, log_topic[0]);
+    TEST_ASSERT_EQUAL_UINT16(Event_TestReactor, log_topic[1]);
+
+    // 入口环已满时，退回到常规的发布路径，入口环中的事件先转入事件队列
+    for (eos_u32_t i = 0; i < (EOS_SIZE_PUB_INGRESS + 2); i ++) {
+        eos_event_pub_topic(Event_TestReactor);
+    }
+    TEST_ASSERT_EQUAL_UINT16(1, (eos_u16_t)(f->ingress.tail - f->ingress.head));
+    TEST_ASSERT_EQUAL_UINT32(EOS_SIZE_PUB_INGRESS + 1, f->ring.count + f->heap.count);
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(2 + EOS_SIZE_PUB_INGRESS + 2, log_count);
+
+#if (EOS_USE_PUB_SUB != 0)
+    // 同一发布者经入口环与直接发布的事件，按发布顺序分发 ------------------------
+    eos_event_sub(&ingress_actor[1].super, Event_TestFsm);
+    eos_event_sub(&ingress_actor[1].super, Event_TestHsm);
+    log_count = 0;
+    eos_event_pub_topic(Event_TestFsm);
+#if (EOS_USE_EVENT_DATA != 0)
+    eos_u8_t data = 0;
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, &data, 1));
+#else
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
+#endif
+    eos_event_pub_topic(Event_TestHsm);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestFsm, EOS_NULL, 0));
+    eos_event_pub_topic(Event_Test);
+    while (eos_once() == EosRun_OK);
+    static const eos_topic_t order[] = {
+        Event_TestFsm, Event_Test, Event_TestHsm, Event_TestFsm, Event_Test
+    };
+    TEST_ASSERT_EQUAL_UINT32(5, log_count);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(order, log_topic, 5);
+#endif
+#endif
+}
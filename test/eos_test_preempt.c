@@ -0,0 +1,190 @@
+/* include ------------------------------------------------------------------ */
+#include "eos_test.h"
+#include "eventos.h"
+#include "event_def.h"
+#include "unity.h"
+#include "eos_test_def.h"
+#include <pthread.h>
+
+#if (EOS_USE_PREEMPT != 0 && EOS_USE_PUB_SUB != 0)
+/* unittest ----------------------------------------------------------------- */
+#define PREEMPT_TEST_ACTORS                     4
+
+enum {
+    PreemptMode_PubRet = 0,
+    PreemptMode_PubTopic,
+    PreemptMode_Lock,
+    PreemptMode_Nested,
+    PreemptMode_Thread,
+};
+
+static eos_reactor_t preempt_actor[PREEMPT_TEST_ACTORS];
+static eos_u8_t log_priority[16];
+static eos_u8_t log_prio_run[16];
+static eos_u32_t log_count;
+static eos_u32_t log_unlock;
+static eos_u8_t mode;
+static eos_t *f;
+
+static void * preempt_producer(void *parameter)
+{
+    (void)parameter;
+    eos_event_pub_topic(Event_TestHsm);
+
+    return EOS_NULL;
+}
+
+static void preempt_handler(eos_reactor_t * const me, eos_event_t const * const e)
+{
+    eos_u8_t priority = me->super.priority;
+
+    if (log_count < 16) {
+        log_priority[log_count] = priority;
+        log_prio_run[log_count] = f->prio_run;
+    }
+    log_count ++;
+
+    if (e->topic == Event_TestReactor) {
+        // 被Actor 2抢占，Actor 2又被Actor 3抢占
+        if (mode == PreemptMode_Nested) {
+            eos_event_pub_topic(Event_TestFsm);
+        }
+        // 所有Actor就绪
+        else if (mode == PreemptMode_PubRet) {
+            TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
+        }
+        else if (mode == PreemptMode_PubTopic) {
+            eos_event_pub_topic(Event_Test);
+        }
+        else if (mode == PreemptMode_Lock) {
+            // 天花板为Actor 2，只有Actor 3可以抢占
+            eos_u8_t prev = eos_lock(2);
+            TEST_ASSERT_EQUAL_UINT8(2, prev);
+            TEST_ASSERT_EQUAL_UINT8(3, f->prio_run);
+            eos_event_pub_topic(Event_Test);
+            TEST_ASSERT_EQUAL_UINT32(2, log_count);
+            eos_unlock(prev);
+            log_unlock = log_count;
+        }
+        else if (mode == PreemptMode_Thread) {
+            // 其他线程请求的抢占，不在该线程中执行，在调度线程退出临界区时执行
+            pthread_t thread;
+            pthread_create(&thread, EOS_NULL, preempt_producer, EOS_NULL);
+            pthread_join(thread, EOS_NULL);
+            TEST_ASSERT_EQUAL_UINT32(1, log_count);
+            eos_port_critical_enter();
+            eos_port_critical_exit();
+            TEST_ASSERT_EQUAL_UINT32(2, log_count);
+        }
+    }
+    else if (e->topic == Event_TestFsm) {
+        eos_event_pub_topic(Event_TestHsm);
+    }
+}
+
+static void preempt_setup(eos_u8_t mode_)
+{
+    f = eos_test_setup(Event_Max);
+    eos_test_reactors(preempt_actor, PREEMPT_TEST_ACTORS, preempt_handler);
+    for (eos_u8_t i = 0; i < PREEMPT_TEST_ACTORS; i ++) {
+        eos_event_sub(&preempt_actor[i].super, Event_Test);
+    }
+    eos_event_sub(&preempt_actor[1].super, Event_TestReactor);
+    eos_event_sub(&preempt_actor[2].super, Event_TestFsm);
+    eos_event_sub(&preempt_actor[3].super, Event_TestHsm);
+    log_count = 0;
+    log_unlock = 0;
+    mode = mode_;
+}
+
+static void preempt_check_order(void)
+{
+    // 1被3、2抢占后继续，0不抢占
+    static const eos_u8_t order[] = { 1, 3, 2, 1, 0 };
+
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestReactor, EOS_NULL, 0));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_UINT32(3, log_count);
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(5, log_count);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(order, log_priority, 5);
+    TEST_ASSERT_EQUAL_UINT8(0, f->prio_run);
+}
+#endif
+
+void eos_test_preempt(void)
+{
+#if (EOS_USE_PREEMPT != 0 && EOS_USE_PUB_SUB != 0)
+    // 运行期间的优先级，没有Actor运行时为0 --------------------------------------
+    preempt_setup(PreemptMode_PubRet);
+    TEST_ASSERT_EQUAL_UINT8(0, f->prio_run);
+    eos_preempt();
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
+    TEST_ASSERT_EQUAL_UINT32(0, log_count);
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(4, log_count);
+    for (eos_u8_t i = 0; i < PREEMPT_TEST_ACTORS; i ++) {
+        TEST_ASSERT_EQUAL_UINT8(PREEMPT_TEST_ACTORS - 1 - i, log_priority[i]);
+        TEST_ASSERT_EQUAL_UINT8(PREEMPT_TEST_ACTORS - i, log_prio_run[i]);
+    }
+
+    // 经由事件队列与入口环发布，都立即抢占 --------------------------------------
+    preempt_setup(PreemptMode_PubRet);
+    preempt_check_order();
+    TEST_ASSERT_EQUAL_UINT8(4, log_prio_run[1]);
+    TEST_ASSERT_EQUAL_UINT8(3, log_prio_run[2]);
+    preempt_setup(PreemptMode_PubTopic);
+    preempt_check_order();
+
+    // 优先级天花板，解锁时被阻挡的Actor立即运行 ---------------------------------
+    preempt_setup(PreemptMode_Lock);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestReactor, EOS_NULL, 0));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_UINT8(3, log_priority[1]);
+    TEST_ASSERT_EQUAL_UINT8(2, log_priority[2]);
+    TEST_ASSERT_EQUAL_UINT32(3, log_unlock);
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(5, log_count);
+    TEST_ASSERT_EQUAL_UINT8(0, f->prio_run);
+
+    // 嵌套抢占 ----------------------------------------------------------------
+    preempt_setup(PreemptMode_Nested);
+    eos_event_sub(&preempt_actor[0].super, Event_TestReactor);
+    eos_event_unsub(&preempt_actor[1].super, Event_TestReactor);
+    eos_event_unsub(&preempt_actor[0].super, Event_Test);
+    eos_event_unsub(&preempt_actor[1].super, Event_Test);
+    eos_event_unsub(&preempt_actor[2].super, Event_Test);
+    eos_event_unsub(&preempt_actor[3].super, Event_Test);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestReactor, EOS_NULL, 0));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_UINT32(3, log_count);
+    for (eos_u8_t i = 0; i < 3; i ++) {
+        TEST_ASSERT_EQUAL_UINT8((i == 0) ? 0 : (i + 1), log_priority[i]);
+        TEST_ASSERT_EQUAL_UINT8((i == 0) ? 1 : (i + 2), log_prio_run[i]);
+    }
+    TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
+    TEST_ASSERT_EQUAL_UINT8(0, f->prio_run);
+
+    // 其他线程请求抢占 --------------------------------------------------------
+    preempt_setup(PreemptMode_Thread);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestReactor, EOS_NULL, 0));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_UINT8(3, log_priority[1]);
+    TEST_ASSERT_EQUAL_UINT8(4, log_prio_run[1]);
+    TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
+    TEST_ASSERT_EQUAL_UINT8(0, f->prio_run);
+
+#if (EOS_USE_MULTI_WORKER != 0 && EOS_MAX_WORKERS >= 2)
+    // 多个worker时不抢占 -------------------------------------------------------
+    preempt_setup(PreemptMode_PubRet);
+    eos_worker_bind(&preempt_actor[3].super, 1);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestReactor, EOS_NULL, 0));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_worker_once(0));
+    TEST_ASSERT_EQUAL_UINT8(1, log_priority[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, log_count);
+    while (eos_worker_once(0) == EosRun_OK);
+    while (eos_worker_once(1) == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(5, log_count);
+#endif
+#endif
+}
@@ -7,7 +7,7 @@
 #include "unity_pack.h"
 
 #if (EOS_USE_PUB_SUB != 0)
-static eos_mcu_t sub_table[Event_Max];
+static eos_sub_t sub_table[Event_Max];
 #endif
 static reactor_t reactor1, reactor2;
 static eos_t *f;
@@ -67,3 +67,103 @@ void eos_test_reactor(void)
         TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
     }
 }
+
+// 多个Actor同时就绪时，按优先级从高到低依次分发 -------------------------------------
+static eos_reactor_t reactor_prio[EOS_MAX_ACTORS];
+static eos_u8_t prio_order[EOS_MAX_ACTORS];
+static eos_u32_t prio_count;
+static eos_bool_t prio_preempt;
+
+static void prio_handler(eos_reactor_t * const me, eos_event_t const * const e)
+{
+    if (prio_count < EOS_MAX_ACTORS) {
+        prio_order[prio_count] = me->super.priority;
+    }
+    prio_count ++;
+
+    // 处理过程中，更高优先级的Actor就绪
+    if (e->topic == Event_TestReactor && prio_preempt == EOS_True) {
+        prio_preempt = EOS_False;
+        eos_event_pub_topic(Event_Test);
+    }
+}
+
+void eos_test_priority(void)
+{
+    f = eos_get_framework();
+    eos_init();
+#if (EOS_USE_PUB_SUB != 0)
+    eos_sub_init(sub_table, Event_Max);
+#endif
+    for (eos_u8_t i = 0; i < EOS_MAX_ACTORS; i ++) {
+        reactor_prio[i].super.enabled = EOS_False;
+        eos_reactor_init(&reactor_prio[i], i, EOS_NULL);
+        eos_reactor_start(&reactor_prio[i], prio_handler);
+#if (EOS_USE_PUB_SUB != 0)
+        eos_event_sub(&reactor_prio[i].super, Event_Test);
+#endif
+    }
+
+    // 全部Actor就绪
+    prio_count = 0;
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(EOS_MAX_ACTORS, prio_count);
+    for (eos_u8_t i = 0; i < EOS_MAX_ACTORS; i ++) {
+        TEST_ASSERT_EQUAL_UINT8(EOS_MAX_ACTORS - 1 - i, prio_order[i]);
+    }
+
+#if (EOS_USE_PUB_SUB != 0)
+    // 部分Actor就绪，优先级间隔分布
+    for (eos_u8_t i = 0; i < EOS_MAX_ACTORS; i += 2) {
+        eos_event_unsub(&reactor_prio[i].super, Event_Test);
+    }
+    prio_count = 0;
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32((EOS_MAX_ACTORS / 2) * 2, prio_count);
+    for (eos_u32_t i = 0; i < prio_count; i ++) {
+        TEST_ASSERT_EQUAL_UINT8(1, prio_order[i] % 2);
+        if (i > 1 && (i % 2) == 0) {
+            TEST_ASSERT(prio_order[i] < prio_order[i - 1]);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, f->sub_general);
+
+    // 批量分发，每轮最多连续处理同一Actor的batch个事件
+    f->batch = 4;
+    eos_event_sub(&reactor_prio[0].super, Event_TestReactor);
+    prio_count = 0;
+    prio_preempt = EOS_False;
+    for (eos_u8_t i = 0; i < 6; i ++) {
+        TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestReactor, EOS_NULL, 0));
+    }
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_UINT32(4, prio_count);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_UINT32(6, prio_count);
+    TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
+
+    // 更高优先级的Actor就绪时，批量分发提前结束
+    prio_count = 0;
+    prio_preempt = EOS_True;
+    for (eos_u8_t i = 0; i < 3; i ++) {
+        TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestReactor, EOS_NULL, 0));
+    }
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+#if (EOS_USE_PREEMPT == 0)
+    TEST_ASSERT_EQUAL_UINT32(1, prio_count);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT(prio_order[1] > 0);
+#else
+    // 抢占式调度下，就绪的Actor立即运行，之后批量分发继续
+    TEST_ASSERT_EQUAL_UINT32(3 + (EOS_MAX_ACTORS / 2), prio_count);
+    TEST_ASSERT(prio_order[1] > 0);
+    TEST_ASSERT_EQUAL_UINT8(0, prio_order[prio_count - 1]);
+#endif
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(3 + (EOS_MAX_ACTORS / 2), prio_count);
+    f->batch = EOS_SIZE_DISPATCH_BATCH;
+#endif
+}
@@ -0,0 +1,115 @@
+/* include ------------------------------------------------------------------ */
+#include "eos_test.h"
+#include "eventos.h"
+#include "event_def.h"
+#include "unity.h"
+#include "eos_test_def.h"
+
+/* unittest ----------------------------------------------------------------- */
+#if (EOS_USE_EVENT_DATA != 0 && EOS_USE_EVENT_REF != 0)
+static eos_reactor_t ref_actor[2];
+static eos_u8_t *held;
+static eos_bool_t hold, release_in_handler;
+static eos_u32_t count_low;
+static eos_t *f;
+
+static void ref_handler(eos_reactor_t * const me, eos_event_t const * const e)
+{
+    if (me == &ref_actor[0]) {
+        count_low ++;
+        return;
+    }
+
+    if (hold == EOS_False) {
+        return;
+    }
+    held = eos_event_ref(e);
+    if (release_in_handler == EOS_True && held != EOS_NULL) {
+        eos_event_unref(held);
+        held = EOS_NULL;
+    }
+}
+
+static void ref_setup(void)
+{
+    f = eos_test_setup(Event_Max);
+    eos_test_reactors(ref_actor, 2, ref_handler);
+#if (EOS_USE_PUB_SUB != 0)
+    eos_event_sub(&ref_actor[1].super, Event_Test);
+    eos_event_sub(&ref_actor[0].super, Event_Test);
+#endif
+    held = EOS_NULL;
+    hold = EOS_False;
+    release_in_handler = EOS_False;
+    count_low = 0;
+}
+#endif
+
+void eos_test_ref(void)
+{
+#if (EOS_USE_EVENT_DATA != 0 && EOS_USE_EVENT_REF != 0)
+    eos_u8_t data[16];
+    for (eos_u8_t i = 0; i < 16; i ++) {
+        data[i] = i;
+    }
+
+    // 所有订阅者处理完毕后，被持有的数据依然有效
+    ref_setup();
+    hold = EOS_True;
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, data, 16));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_NOT_NULL(held);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_UINT32(1, count_low);
+    TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
+    TEST_ASSERT_EQUAL_UINT16(1, f->heap.count);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(data, held, 16);
+
+    // 持有期间，其他事件正常收发
+    eos_u8_t *held_1st = held;
+    hold = EOS_False;
+    for (eos_u32_t i = 0; i < 100; i ++) {
+        TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, data, 8));
+        TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+        TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    }
+    TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
+    TEST_ASSERT_EQUAL_UINT16(1, f->heap.count);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(data, held_1st, 16);
+
+    // 最后一个持有者释放数据
+    eos_event_unref(held_1st);
+    TEST_ASSERT_EQUAL_UINT16(0, f->heap.count);
+    TEST_ASSERT_EQUAL_UINT8(1, f->heap.empty);
+
+    // 在订阅者处理完毕之前释放，由最后一个订阅者回收
+    ref_setup();
+    hold = EOS_True;
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, data, 16));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    eos_event_unref(held);
+    TEST_ASSERT_EQUAL_UINT16(1, f->heap.count);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_UINT16(0, f->heap.count);
+    TEST_ASSERT_EQUAL_UINT8(1, f->heap.empty);
+
+    // 在事件处理函数中持有并释放，事件处理完毕后回收
+    ref_setup();
+    hold = EOS_True;
+    release_in_handler = EOS_True;
+#if (EOS_USE_PUB_SUB != 0)
+    eos_event_unsub(&ref_actor[0].super, Event_Test);
+#endif
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, data, 16));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_UINT16(0, f->heap.count);
+    TEST_ASSERT_EQUAL_UINT8(1, f->heap.empty);
+
+    // 不携带数据的事件，没有可持有的数据
+    release_in_handler = EOS_False;
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_NULL(held);
+    TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
+#endif
+}
@@ -0,0 +1,155 @@
+/* include ------------------------------------------------------------------ */
+#include "eos_test.h"
+#include "eventos.h"
+#include "event_def.h"
+#include "unity.h"
+#include "eos_test_def.h"
+
+/* unittest ----------------------------------------------------------------- */
+#define RING_TEST_LOG_SIZE                      256
+
+static eos_reactor_t ring_actor[2];
+static eos_topic_t log_topic[RING_TEST_LOG_SIZE];
+static eos_u16_t log_size[RING_TEST_LOG_SIZE];
+static eos_u32_t log_count;
+static eos_u32_t count_low;
+static eos_u16_t low_size[4];
+static eos_t *f;
+
+static void ring_handler(eos_reactor_t * const me, eos_event_t const * const e)
+{
+    if (me == &ring_actor[0]) {
+        if (count_low < 4) {
+            low_size[count_low] = e->size;
+        }
+        count_low ++;
+        return;
+    }
+
+    TEST_ASSERT(log_count < RING_TEST_LOG_SIZE);
+    log_topic[log_count] = e->topic;
+    log_size[log_count] = e->size;
+    if (e->size != 0) {
+        TEST_ASSERT_EQUAL_UINT8((eos_u8_t)log_count, ((eos_u8_t *)e->data)[0]);
+    }
+    log_count ++;
+}
+
+static void ring_setup(void)
+{
+    f = eos_test_setup(Event_Max);
+    eos_test_reactors(ring_actor, 2, ring_handler);
+#if (EOS_USE_PUB_SUB != 0)
+    eos_event_sub(&ring_actor[1].super, Event_Test);
+    eos_event_sub(&ring_actor[1].super, Event_TestReactor);
+    eos_event_sub(&ring_actor[0].super, Event_Test);
+#endif
+    log_count = 0;
+    count_low = 0;
+}
+
+// ring_actor[0]空闲，只由ring_actor[1]处理num个事件，之后两者都能收到新的事件
+static void ring_wrap(eos_u32_t num)
+{
+    ring_setup();
+    for (eos_u32_t i = 0; i < num; i ++) {
+        log_count = 0;
+        TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestReactor, EOS_NULL, 0));
+        TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+        TEST_ASSERT_EQUAL_UINT32(1, log_count);
+    }
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_UINT32(1, count_low);
+    TEST_ASSERT_EQUAL_UINT16(0, f->ring.count);
+    TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
+}
+
+void eos_test_ring(void)
+{
+    ring_setup();
+
+    // 不携带数据的事件不使用Heap
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestReactor, EOS_NULL, 0));
+    TEST_ASSERT_EQUAL_UINT16(1, f->ring.count);
+    TEST_ASSERT_EQUAL_UINT8(1, f->heap.empty);
+    TEST_ASSERT_EQUAL_UINT32(2, f->sub_general);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_UINT16(0, f->ring.count);
+    TEST_ASSERT_EQUAL_UINT32(0, f->sub_general);
+    TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
+    TEST_ASSERT_EQUAL_UINT32(1, log_count);
+    TEST_ASSERT_EQUAL_UINT16(0, log_size[0]);
+
+    // 多个订阅者都取走后，记录才被释放
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
+    TEST_ASSERT_EQUAL_UINT32(3, f->sub_general);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_UINT16(1, f->ring.count);
+    TEST_ASSERT_EQUAL_UINT32(1, f->sub_general);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    TEST_ASSERT_EQUAL_UINT16(0, f->ring.count);
+    TEST_ASSERT_EQUAL_UINT32(1, count_low);
+    TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
+
+    // Ring与Heap中的事件，按发布顺序分发
+    ring_setup();
+    eos_u8_t data;
+    for (eos_u32_t i = 0; i < 24; i ++) {
+        data = (eos_u8_t)i;
+        if ((i % 3) == 0) {
+            TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestReactor, &data, 1));
+        }
+        else {
+            TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestReactor, EOS_NULL, 0));
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT16(16, f->ring.count);
+    TEST_ASSERT_EQUAL_UINT16(8, f->heap.count);
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(24, log_count);
+    for (eos_u32_t i = 0; i < 24; i ++) {
+        TEST_ASSERT_EQUAL_UINT16(Event_TestReactor, log_topic[i]);
+        TEST_ASSERT_EQUAL_UINT16(((i % 3) == 0) ? 1 : 0, log_size[i]);
+    }
+
+    // Ring已满时，不携带数据的事件转入Heap，顺序不变
+    ring_setup();
+    for (eos_u32_t i = 0; i < (EOS_SIZE_TOPIC_QUEUE + 8); i ++) {
+        TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestReactor, EOS_NULL, 0));
+    }
+    data = (eos_u8_t)(EOS_SIZE_TOPIC_QUEUE + 8);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestReactor, &data, 1));
+    TEST_ASSERT_EQUAL_UINT16(EOS_SIZE_TOPIC_QUEUE, f->ring.count);
+    TEST_ASSERT_EQUAL_UINT16(9, f->heap.count);
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(EOS_SIZE_TOPIC_QUEUE + 9, log_count);
+    TEST_ASSERT_EQUAL_UINT16(1, log_size[EOS_SIZE_TOPIC_QUEUE + 8]);
+    TEST_ASSERT_EQUAL_UINT16(0, f->ring.count);
+    TEST_ASSERT_EQUAL_UINT8(1, f->heap.empty);
+
+    // 序号回绕后，Ring依然正常工作。空闲Actor的游标，在回绕到恰好落入队列时也不出错
+    ring_wrap(70000);
+    ring_wrap(65535);
+    ring_wrap(65536);
+
+    // Heap中的事件比Ring中的记录早发布很久时，依然先被分发
+    ring_setup();
+    data = 0;
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, &data, 1));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+    for (eos_u32_t i = 1; i < 40000; i ++) {
+        log_count = 0;
+        TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestReactor, EOS_NULL, 0));
+        TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
+        TEST_ASSERT_EQUAL_UINT32(1, log_count);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, count_low);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(2, count_low);
+    TEST_ASSERT_EQUAL_UINT16(1, low_size[0]);
+    TEST_ASSERT_EQUAL_UINT16(0, low_size[1]);
+    TEST_ASSERT_EQUAL_UINT8(1, f->heap.empty);
+}
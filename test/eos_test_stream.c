@@ -0,0 +1,166 @@
+/* include ------------------------------------------------------------------ */
+#include "eos_test.h"
+#include "eventos.h"
+#include "event_def.h"
+#include "unity.h"
+#include "eos_test_def.h"
+#include <sys/socket.h>
+#include <unistd.h>
+
+#if (EOS_USE_BRIDGE_STREAM != 0 && EOS_USE_PUB_SUB != 0)
+/* unittest ----------------------------------------------------------------- */
+extern void (* eos_bridge_send_hook)(eos_u8_t const *data, eos_u32_t size);
+
+static eos_reactor_t stream_actor[1];
+static eos_topic_t log_topic[16];
+static eos_u32_t log_size[16];
+static eos_u8_t log_data[16];
+static eos_u32_t log_count;
+static eos_u32_t send_count;
+static int sock[2];
+static eos_u8_t frame[2 * EOS_SIZE_BRIDGE_FRAME];
+static eos_t *f;
+
+static void stream_handler(eos_reactor_t * const me, eos_event_t const * const e)
+{
+    (void)me;
+
+    if (log_count < 16) {
+        log_topic[log_count] = e->topic;
+        log_size[log_count] = e->size;
+        log_data[log_count] = (e->size != 0) ? ((eos_u8_t *)e->data)[e->size - 1] : 0;
+    }
+    log_count ++;
+}
+
+// 经socketpair回环，模拟串口
+static void stream_send(eos_u8_t const *data, eos_u32_t size)
+{
+    TEST_ASSERT_EQUAL_INT(size, write(sock[0], data, size));
+    send_count ++;
+}
+
+// 取出对端收到的全部字节
+static eos_u32_t stream_recv(void)
+{
+    ssize_t ret = recv(sock[1], frame, sizeof(frame), MSG_DONTWAIT);
+
+    return (ret < 0) ? 0 : (eos_u32_t)ret;
+}
+
+static void stream_setup(void)
+{
+    f = eos_test_setup(Event_Max);
+    eos_test_reactors(stream_actor, 1, stream_handler);
+    eos_event_sub(&stream_actor[0].super, Event_Test);
+    eos_event_sub(&stream_actor[0].super, Event_TestFsm);
+    eos_bridge_export(Event_Test);
+    eos_bridge_export(Event_TestHsm);
+    eos_bridge_stream_start();
+    log_count = 0;
+    send_count = 0;
+}
+#endif
+
+void eos_test_bridge_stream(void)
+{
+#if (EOS_USE_BRIDGE_STREAM != 0 && EOS_USE_PUB_SUB != 0)
+    TEST_ASSERT_EQUAL_INT(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sock));
+    eos_bridge_send_hook = stream_send;
+    stream_setup();
+
+    // 一轮调度中转发的事件合为一帧 ---------------------------------------------
+    eos_event_pub_topic(Event_Test);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestHsm, EOS_NULL, 0));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestFsm, EOS_NULL, 0));
+#if (EOS_USE_EVENT_DATA != 0)
+    // 数据中有0x00，以及超过254个字节的非零数据
+    eos_u8_t data[300];
+    for (eos_u32_t i = 0; i < 300; i ++) {
+        data[i] = (i < 10) ? 0 : (eos_u8_t)(i % 255 + 1);
+    }
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, data, 300));
+#endif
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(1, send_count);
+    eos_u32_t len = stream_recv();
+    TEST_ASSERT_EQUAL_UINT8(0, frame[len - 1]);
+    for (eos_u32_t i = 0; i < len - 1; i ++) {
+        TEST_ASSERT_NOT_EQUAL(0, frame[i]);
+    }
+#if (EOS_USE_EVENT_DATA != 0)
+    TEST_ASSERT_EQUAL_UINT32(3, log_count);
+#else
+    TEST_ASSERT_EQUAL_UINT32(2, log_count);
+#endif
+
+    // 逐段喂入，校验通过后在本地发布，不再转发回去 ------------------------------
+    log_count = 0;
+    for (eos_u32_t i = 0; i < len; i += 7) {
+        eos_bridge_stream_feed(&frame[i], (len - i < 7) ? (len - i) : 7);
+    }
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(1, send_count);
+    TEST_ASSERT_EQUAL_UINT32(0, f->stream.error);
+    TEST_ASSERT_EQUAL_UINT16(Event_Test, log_topic[0]);
+#if (EOS_USE_EVENT_DATA != 0)
+    TEST_ASSERT_EQUAL_UINT32(2, log_count);
+    // 经入口环发布的事件，在下一次直接发布前转发，位于帧的开头
+    TEST_ASSERT_EQUAL_UINT32(0, log_size[0]);
+    TEST_ASSERT_EQUAL_UINT32(300, log_size[1]);
+    TEST_ASSERT_EQUAL_UINT8(data[299], log_data[1]);
+#else
+    TEST_ASSERT_EQUAL_UINT32(1, log_count);
+#endif
+
+    // 损坏的帧被丢弃，在下一帧重新同步 -----------------------------------------
+    log_count = 0;
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
+    eos_bridge_flush();
+    len = stream_recv();
+    TEST_ASSERT_EQUAL_UINT32(2, send_count);
+    eos_u8_t byte = frame[1];
+    frame[1] = (byte == 0xff) ? 0x01 : (byte + 1);
+    eos_bridge_stream_feed(frame, len);
+    TEST_ASSERT_EQUAL_UINT32(1, f->stream.error);
+    // 帧前的噪声与该帧一同丢弃
+    eos_u8_t noise[2] = { 0x11, 0x22 };
+    frame[1] = byte;
+    eos_bridge_stream_feed(noise, 2);
+    eos_bridge_stream_feed(frame, len);
+    TEST_ASSERT_EQUAL_UINT32(2, f->stream.error);
+    // 连续的帧尾不是错误
+    eos_bridge_stream_feed(frame, len);
+    eos_bridge_stream_feed(frame + len - 1, 1);
+    TEST_ASSERT_EQUAL_UINT32(2, f->stream.error);
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(2, log_count);
+
+#if (EOS_USE_EVENT_DATA != 0)
+    // 一帧装满后换到另一个缓冲区，两个缓冲区都满时丢弃 -------------------------
+    stream_setup();
+    eos_u32_t per_frame = EOS_SIZE_BRIDGE_FRAME / 110;
+    for (eos_u32_t i = 0; i < 2 * per_frame + 2; i ++) {
+        data[99] = (eos_u8_t)(i + 1);
+        TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestHsm, data, 100));
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, f->stream.lost);
+    eos_bridge_flush();
+    TEST_ASSERT_EQUAL_UINT32(2, send_count);
+    len = stream_recv();
+    eos_bridge_stream_feed(frame, len);
+    TEST_ASSERT_EQUAL_UINT32(0, f->stream.error);
+    // 没有本地订阅者，经本地发布的事件都不分发
+    TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
+    eos_event_sub(&stream_actor[0].super, Event_TestHsm);
+    eos_bridge_stream_feed(frame, len);
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(2 * per_frame, log_count);
+    TEST_ASSERT_EQUAL_UINT8(2 * per_frame, log_data[2 * per_frame - 1]);
+#endif
+
+    eos_bridge_send_hook = EOS_NULL;
+    close(sock[0]);
+    close(sock[1]);
+#endif
+}
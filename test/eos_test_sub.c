@@ -8,7 +8,7 @@
 /* unittest ----------------------------------------------------------------- */
 #if (EOS_USE_SM_MODE != 0)
 #if (EOS_USE_PUB_SUB != 0)
-static eos_mcu_t eos_sub_table[Event_Max];
+static eos_sub_t eos_sub_table[Event_Max];
 #endif
 static fsm_t fsm, fsm2;
 static eos_t *f;
@@ -34,12 +34,12 @@ void eos_test_sub(void)
     TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
 #if (EOS_USE_PUB_SUB != 0)
     TEST_ASSERT_EQUAL_INT8(EosRun_NoActorSub, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
-    TEST_ASSERT_EQUAL_INT8(0, f->heap.sub_general);
-    TEST_ASSERT_EQUAL_INT8(0, f->heap.count);
+    TEST_ASSERT_EQUAL_INT8(0, f->sub_general);
+    TEST_ASSERT_EQUAL_INT8(0, f->ring.count);
 #else
     TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
-    TEST_ASSERT_EQUAL_INT8(1, f->heap.count);
-    TEST_ASSERT_EQUAL_INT8(1, f->heap.sub_general);
+    TEST_ASSERT_EQUAL_INT8(1, f->ring.count);
+    TEST_ASSERT_EQUAL_INT8(1, f->sub_general);
     TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_once());
     TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
     TEST_ASSERT_EQUAL_UINT8(1, f->heap.empty);
@@ -49,8 +49,8 @@ void eos_test_sub(void)
     // eos_event_pub_ret
     for (int i = 0; i < EOS_EVENT_PUB_TIMES; i ++) {
         TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestFsm, EOS_NULL, 0));
-        TEST_ASSERT_EQUAL_INT8((1 + i), f->heap.count);
-        TEST_ASSERT_EQUAL_INT8(1, f->heap.sub_general);
+        TEST_ASSERT_EQUAL_INT8((1 + i), f->ring.count);
+        TEST_ASSERT_EQUAL_INT8(1, f->sub_general);
         TEST_ASSERT_EQUAL_UINT32(0, fsm_state(&fsm));
         TEST_ASSERT_EQUAL_UINT32(0, fsm_event_count(&fsm));
     }
@@ -64,7 +64,7 @@ void eos_test_sub(void)
         TEST_ASSERT_EQUAL_UINT32(state, fsm_state(&fsm));
         TEST_ASSERT_EQUAL_UINT32((1 + i), fsm_event_count(&fsm));
 
-        TEST_ASSERT_EQUAL_INT8((EOS_EVENT_PUB_TIMES - 1 - i), f->heap.count);
+        TEST_ASSERT_EQUAL_INT8((EOS_EVENT_PUB_TIMES - 1 - i), f->ring.count);
     }
 
     TEST_ASSERT_EQUAL_UINT32(0, fsm_state(&fsm));
@@ -78,13 +78,13 @@ void eos_test_sub(void)
 
     for (int i = 0; i < EOS_EVENT_PUB_TIMES; i ++) {
         TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestFsm, EOS_NULL, 0));
-        TEST_ASSERT_EQUAL_INT8((1 + i), f->heap.count);
-        TEST_ASSERT_EQUAL_INT8(3, f->heap.sub_general);
+        TEST_ASSERT_EQUAL_INT8((1 + i), f->ring.count);
+        TEST_ASSERT_EQUAL_INT8(3, f->sub_general);
         TEST_ASSERT_EQUAL_UINT32(0, fsm_state(&fsm));
         TEST_ASSERT_EQUAL_UINT32(0, fsm_event_count(&fsm));
     }
 
-    TEST_ASSERT_EQUAL_UINT32(3, f->heap.sub_general);
+    TEST_ASSERT_EQUAL_UINT32(3, f->sub_general);
 
     for (int i = 0; i < EOS_EVENT_PUB_TIMES; i ++) {
         state = (i % 2 == 1) ? 1 : 0;
@@ -97,10 +97,10 @@ void eos_test_sub(void)
         TEST_ASSERT_EQUAL_UINT32((1 + i), fsm_event_count(&fsm2));
         TEST_ASSERT_EQUAL_UINT32(0, fsm_event_count(&fsm));
 
-        TEST_ASSERT_EQUAL_INT8(EOS_EVENT_PUB_TIMES, f->heap.count);
+        TEST_ASSERT_EQUAL_INT8(EOS_EVENT_PUB_TIMES, f->ring.count);
     }
 
-    TEST_ASSERT_EQUAL_UINT32(1, f->heap.sub_general);
+    TEST_ASSERT_EQUAL_UINT32(1, f->sub_general);
 
     for (int i = 0; i < EOS_EVENT_PUB_TIMES; i ++) {
         state = (i % 2 == 1) ? 1 : 0;
@@ -113,10 +113,10 @@ void eos_test_sub(void)
         TEST_ASSERT_EQUAL_UINT32((1 + i), fsm_event_count(&fsm));
         TEST_ASSERT_EQUAL_UINT32(EOS_EVENT_PUB_TIMES, fsm_event_count(&fsm2));
 
-        TEST_ASSERT_EQUAL_INT8((EOS_EVENT_PUB_TIMES - 1 - i), f->heap.count);
+        TEST_ASSERT_EQUAL_INT8((EOS_EVENT_PUB_TIMES - 1 - i), f->ring.count);
     }
 
-    TEST_ASSERT_EQUAL_UINT32(0, f->heap.sub_general);
+    TEST_ASSERT_EQUAL_UINT32(0, f->sub_general);
     TEST_ASSERT_EQUAL_UINT32(EOS_HEAP_MAX, f->heap.queue);
 
     TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
@@ -127,14 +127,14 @@ void eos_test_sub(void)
     eos_event_unsub(&fsm2.super.super, Event_TestFsm);
     for (int i = 0; i < EOS_EVENT_PUB_TIMES; i ++) {
         TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_TestFsm, EOS_NULL, 0));
-        TEST_ASSERT_EQUAL_INT8((1 + i), f->heap.count);
-        TEST_ASSERT_EQUAL_INT8(1, f->heap.sub_general);
+        TEST_ASSERT_EQUAL_INT8((1 + i), f->ring.count);
+        TEST_ASSERT_EQUAL_INT8(1, f->sub_general);
         TEST_ASSERT_EQUAL_UINT32(0, fsm_state(&fsm));
         TEST_ASSERT_EQUAL_UINT32(EOS_EVENT_PUB_TIMES, fsm_event_count(&fsm));
-        TEST_ASSERT_EQUAL_UINT8(0, f->heap.empty);
+        TEST_ASSERT_EQUAL_UINT8(1, f->heap.empty);
     }
 
-    TEST_ASSERT_EQUAL_UINT32(1, f->heap.sub_general);
+    TEST_ASSERT_EQUAL_UINT32(1, f->sub_general);
 
     for (int i = 0; i < EOS_EVENT_PUB_TIMES; i ++) {
         state = (i % 2 == 1) ? 1 : 0;
@@ -147,10 +147,10 @@ void eos_test_sub(void)
         TEST_ASSERT_EQUAL_UINT32(10, fsm_event_count(&fsm2));
         TEST_ASSERT_EQUAL_UINT32((11 + i), fsm_event_count(&fsm));
 
-        TEST_ASSERT_EQUAL_INT8((EOS_EVENT_PUB_TIMES - i - 1), f->heap.count);
+        TEST_ASSERT_EQUAL_INT8((EOS_EVENT_PUB_TIMES - i - 1), f->ring.count);
     }
 
-    TEST_ASSERT_EQUAL_UINT32(0, f->heap.sub_general);
+    TEST_ASSERT_EQUAL_UINT32(0, f->sub_general);
     TEST_ASSERT_EQUAL_UINT32(EOS_HEAP_MAX, f->heap.queue);
 
     TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
@@ -161,14 +161,14 @@ void eos_test_sub(void)
 
     for (int i = 0; i < EOS_EVENT_PUB_TIMES; i ++) {
         TEST_ASSERT_EQUAL_INT8(EosRun_NoActorSub, eos_event_pub_ret(Event_TestFsm, EOS_NULL, 0));
-        TEST_ASSERT_EQUAL_INT8(0, f->heap.count);
-        TEST_ASSERT_EQUAL_INT8(0, f->heap.sub_general);
+        TEST_ASSERT_EQUAL_INT8(0, f->ring.count);
+        TEST_ASSERT_EQUAL_INT8(0, f->sub_general);
         TEST_ASSERT_EQUAL_UINT32(0, fsm_state(&fsm));
         TEST_ASSERT_EQUAL_UINT32(EOS_EVENT_PUB_TIMES * 2, fsm_event_count(&fsm));
         TEST_ASSERT_EQUAL_UINT8(1, f->heap.empty);
     }
 
-    TEST_ASSERT_EQUAL_UINT32(0, f->heap.sub_general);
+    TEST_ASSERT_EQUAL_UINT32(0, f->sub_general);
     TEST_ASSERT_EQUAL_UINT32(EOS_HEAP_MAX, f->heap.queue);
 
     TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
@@ -0,0 +1,82 @@
+/* include ------------------------------------------------------------------ */
+#include "eos_test.h"
+#include "eventos.h"
+#include "unity.h"
+#include "eos_test_def.h"
+
+#if (EOS_USE_PUB_SUB != 0 && EOS_USE_SUB_CONST != 0)
+#include "eos_test_topic.h"
+
+/* unittest ----------------------------------------------------------------- */
+#define SUB_CONST_TEST_ACTORS                   3
+
+EOS_SUB_TABLE(eos_test_sub_table, EOS_TEST_TOPICS, Topic_Max);
+
+static eos_sub_t sub_table[Topic_Max];
+static eos_reactor_t sub_actor[SUB_CONST_TEST_ACTORS];
+static eos_u8_t log_priority[8];
+static eos_u32_t log_count;
+
+static void sub_const_handler(eos_reactor_t * const me, eos_event_t const * const e)
+{
+    (void)e;
+
+    if (log_count < 8) {
+        log_priority[log_count] = me->super.priority;
+    }
+    log_count ++;
+}
+
+static void sub_const_check(eos_topic_t topic, eos_u32_t count, eos_u8_t const *priority)
+{
+    log_count = 0;
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(topic, EOS_NULL, 0));
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(count, log_count);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(priority, log_priority, count);
+}
+#endif
+
+void eos_test_sub_const(void)
+{
+#if (EOS_USE_PUB_SUB != 0 && EOS_USE_SUB_CONST != 0)
+    // 生成的主题枚举与订阅表 ----------------------------------------------------
+    TEST_ASSERT_EQUAL_UINT16(Event_User, Topic_Key);
+    TEST_ASSERT_EQUAL_UINT16(Event_User + 3, Topic_Max);
+    TEST_ASSERT_EQUAL_UINT32(EOS_SUB_BIT(0) | EOS_SUB_BIT(2), eos_test_sub_table[Topic_Key]);
+    TEST_ASSERT_EQUAL_UINT32(EOS_SUB_BIT(1), eos_test_sub_table[Topic_Tick]);
+    for (eos_topic_t i = 0; i < Event_User; i ++) {
+        TEST_ASSERT_EQUAL_UINT32(0, eos_test_sub_table[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, eos_test_sub_table[Topic_Log]);
+
+    // 只有编译期订阅表，无需运行时的订阅表与订阅调用 ----------------------------
+    (void)eos_test_setup(0);
+    eos_sub_init_const(eos_test_sub_table, Topic_Max);
+    eos_test_reactors(sub_actor, SUB_CONST_TEST_ACTORS, sub_const_handler);
+    static const eos_u8_t order_key[] = { 2, 0 };
+    static const eos_u8_t order_tick[] = { 1 };
+    sub_const_check(Topic_Key, 2, order_key);
+    sub_const_check(Topic_Tick, 1, order_tick);
+    TEST_ASSERT_EQUAL_INT8(EosRun_NoActorSub, eos_event_pub_ret(Topic_Log, EOS_NULL, 0));
+    eos_event_pub_topic(Topic_Key);
+    log_count = 0;
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(2, log_count);
+
+    // 运行时的订阅表作为叠加层 --------------------------------------------------
+    eos_sub_init(sub_table, Topic_Max);
+    eos_event_sub(&sub_actor[1].super, Topic_Log);
+    eos_event_sub(&sub_actor[1].super, Topic_Key);
+    static const eos_u8_t order_log[] = { 1 };
+    static const eos_u8_t order_key_all[] = { 2, 1, 0 };
+    sub_const_check(Topic_Log, 1, order_log);
+    sub_const_check(Topic_Key, 3, order_key_all);
+    // 取消订阅只影响叠加层
+    eos_event_unsub(&sub_actor[1].super, Topic_Key);
+    eos_event_unsub(&sub_actor[0].super, Topic_Key);
+    sub_const_check(Topic_Key, 2, order_key);
+    eos_event_unsub(&sub_actor[1].super, Topic_Log);
+    TEST_ASSERT_EQUAL_INT8(EosRun_NoActorSub, eos_event_pub_ret(Topic_Log, EOS_NULL, 0));
+#endif
+}
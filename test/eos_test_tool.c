@@ -0,0 +1,45 @@
+/* include ------------------------------------------------------------------ */
+#include "eos_test.h"
+#include "eventos.h"
+#include "unity.h"
+#include "eos_test_def.h"
+
+/* fixture ------------------------------------------------------------------ */
+#define EOS_TEST_SUB_TABLE_SIZE                 64
+
+#if (EOS_USE_PUB_SUB != 0)
+static eos_sub_t test_sub_table[EOS_TEST_SUB_TABLE_SIZE];
+#endif
+
+void * eos_test_setup(eos_topic_t topic_max)
+{
+    eos_init();
+#if (EOS_USE_PUB_SUB != 0)
+    if (topic_max != 0) {
+        TEST_ASSERT(topic_max <= EOS_TEST_SUB_TABLE_SIZE);
+        eos_sub_init(test_sub_table, topic_max);
+    }
+#else
+    (void)topic_max;
+#endif
+
+    return eos_get_framework();
+}
+
+void eos_test_reactors(eos_reactor_t *actor, eos_u8_t num, eos_event_handler handler)
+{
+    for (eos_u8_t i = 0; i < num; i ++) {
+        actor[i].super.enabled = EOS_False;
+        eos_reactor_init(&actor[i], i, EOS_NULL);
+        eos_reactor_start(&actor[i], handler);
+    }
+}
+
+#if (EOS_USE_SM_MODE != 0)
+void eos_test_sm_start(eos_sm_t * const sm, eos_state_handler state_init)
+{
+    sm->super.enabled = EOS_False;
+    eos_sm_init(sm, 0, EOS_NULL);
+    eos_sm_start(sm, state_init);
+}
+#endif
@@ -0,0 +1,16 @@
+// 由tools/topic_gen.py从eos_test_topic.topic生成，请勿手动修改。
+#ifndef EOS_TEST_TOPIC_H__
+#define EOS_TEST_TOPIC_H__
+
+#include "eventos.h"
+
+#define EOS_TEST_TOPICS(X)                                         \
+    X(Topic_Key,           EOS_SUB_ACTOR(0) | EOS_SUB_ACTOR(2))    \
+    X(Topic_Tick,          EOS_SUB_ACTOR(1))                       \
+    X(Topic_Log,           0)
+
+EOS_TOPIC_ENUM(EOS_TEST_TOPICS, Topic_Max);
+
+extern eos_sub_t const eos_test_sub_table[Topic_Max];
+
+#endif
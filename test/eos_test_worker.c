@@ -0,0 +1,181 @@
+/* include ------------------------------------------------------------------ */
+#include "eos_test.h"
+#include "eventos.h"
+#include "event_def.h"
+#include "unity.h"
+#include "eos_test_def.h"
+#include <pthread.h>
+#include <sched.h>
+
+#if (EOS_USE_MULTI_WORKER != 0)
+/* unittest ----------------------------------------------------------------- */
+#define WORKER_TEST_ACTORS                      4
+#define WORKER_TEST_TIMES                       200
+
+static eos_reactor_t worker_actor[WORKER_TEST_ACTORS];
+static eos_u8_t log_priority[8];
+static eos_u32_t log_count;
+static eos_u32_t count[WORKER_TEST_ACTORS];
+static eos_bool_t busy[WORKER_TEST_ACTORS];
+static pthread_t owner[WORKER_TEST_ACTORS];
+static eos_bool_t threaded;
+static eos_bool_t stealing;
+static eos_bool_t nested;
+
+static void worker_handler(eos_reactor_t * const me, eos_event_t const * const e)
+{
+    eos_u8_t priority = me->super.priority;
+    (void)e;
+#if (EOS_USE_TIME_EVENT != 0)
+    // 各worker分别记录正在运行的Actor，并行与嵌套调度时都不会互相覆盖
+    TEST_ASSERT_EQUAL_UINT8(priority, eos_actor_current());
+#endif
+
+    if (threaded == EOS_False) {
+        if (log_count < 8) {
+            log_priority[log_count] = priority;
+        }
+        log_count ++;
+        // 模拟另一个worker在此时调度
+        if (nested == EOS_True) {
+            nested = EOS_False;
+            TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_worker_once(0));
+#if (EOS_USE_TIME_EVENT != 0)
+            TEST_ASSERT_EQUAL_UINT8(priority, eos_actor_current());
+#endif
+        }
+        return;
+    }
+
+    // 同一Actor不会被并行执行。未打开工作窃取时，总是在同一线程中处理。
+    TEST_ASSERT_EQUAL_UINT8(EOS_False, busy[priority]);
+    busy[priority] = EOS_True;
+    if (count[priority] == 0) {
+        owner[priority] = pthread_self();
+    }
+    if (stealing == EOS_False) {
+        TEST_ASSERT(pthread_equal(owner[priority], pthread_self()));
+    }
+    count[priority] ++;
+#if (EOS_USE_TIME_EVENT != 0)
+    sched_yield();
+    TEST_ASSERT_EQUAL_UINT8(priority, eos_actor_current());
+#endif
+    busy[priority] = EOS_False;
+}
+
+static void * worker_thread(void *parameter)
+{
+    eos_u8_t worker = (eos_u8_t)(eos_pointer_t)parameter;
+
+    while (eos_worker_once(worker) == EosRun_OK);
+
+    return EOS_NULL;
+}
+
+static void worker_run_threads(void)
+{
+    pthread_t thread[2];
+
+    for (eos_u32_t i = 0; i < WORKER_TEST_TIMES; i ++) {
+        TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_event_pub_ret(Event_Test, EOS_NULL, 0));
+    }
+    for (eos_u8_t i = 0; i < 2; i ++) {
+        pthread_create(&thread[i], EOS_NULL, worker_thread, (void *)(eos_pointer_t)i);
+    }
+    for (eos_u8_t i = 0; i < 2; i ++) {
+        pthread_join(thread[i], EOS_NULL);
+    }
+    for (eos_u8_t i = 0; i < WORKER_TEST_ACTORS; i ++) {
+        TEST_ASSERT_EQUAL_UINT32(WORKER_TEST_TIMES, count[i]);
+    }
+    TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_once());
+}
+
+static void worker_setup(void)
+{
+    (void)eos_test_setup(Event_Max);
+    eos_test_reactors(worker_actor, WORKER_TEST_ACTORS, worker_handler);
+    for (eos_u8_t i = 0; i < WORKER_TEST_ACTORS; i ++) {
+#if (EOS_USE_PUB_SUB != 0)
+        eos_event_sub(&worker_actor[i].super, Event_Test);
+#endif
+        count[i] = 0;
+        busy[i] = EOS_False;
+    }
+    log_count = 0;
+}
+#endif
+
+void eos_test_worker(void)
+{
+#if (EOS_USE_MULTI_WORKER != 0 && EOS_USE_PUB_SUB != 0 && EOS_MAX_WORKERS >= 2)
+    // 每个worker只分发绑定到它的Actor，按优先级从高到低 -------------------------
+    threaded = EOS_False;
+    worker_setup();
+    TEST_ASSERT_EQUAL_UINT8(1, eos_worker_num());
+    eos_worker_bind(&worker_actor[1].super, 1);
+    eos_worker_bind(&worker_actor[3].super, 1);
+    TEST_ASSERT_EQUAL_UINT8(2, eos_worker_num());
+
+    eos_event_pub_topic(Event_Test);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_worker_once(0));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_worker_once(0));
+    TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_worker_once(0));
+    TEST_ASSERT_EQUAL_UINT32(2, log_count);
+    TEST_ASSERT_EQUAL_UINT8(2, log_priority[0]);
+    TEST_ASSERT_EQUAL_UINT8(0, log_priority[1]);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_worker_once(1));
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_worker_once(1));
+    TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_worker_once(1));
+    TEST_ASSERT_EQUAL_UINT32(4, log_count);
+    TEST_ASSERT_EQUAL_UINT8(3, log_priority[2]);
+    TEST_ASSERT_EQUAL_UINT8(1, log_priority[3]);
+
+    // eos_once()不区分worker
+    eos_event_pub_topic(Event_Test);
+    while (eos_once() == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(8, log_count);
+    TEST_ASSERT_EQUAL_UINT8(3, log_priority[4]);
+
+    // 重新绑定后，worker的数量随之减少
+    eos_worker_bind(&worker_actor[1].super, 0);
+    eos_worker_bind(&worker_actor[3].super, 0);
+    TEST_ASSERT_EQUAL_UINT8(1, eos_worker_num());
+
+#if (EOS_USE_WORK_STEALING != 0)
+    // 工作窃取，正在运行的Actor不会被其他worker选中 ------------------------------
+    worker_setup();
+    eos_worker_steal(2);
+    TEST_ASSERT_EQUAL_UINT8(2, eos_worker_num());
+    eos_event_pub_topic(Event_Test);
+    eos_event_pub_topic(Event_Test);
+    nested = EOS_True;
+    // worker 1没有自己的Actor，窃取Actor 3；其运行期间，worker 0跳过Actor 3
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_worker_once(1));
+    TEST_ASSERT_EQUAL_UINT32(2, log_count);
+    TEST_ASSERT_EQUAL_UINT8(3, log_priority[0]);
+    TEST_ASSERT_EQUAL_UINT8(2, log_priority[1]);
+    TEST_ASSERT_EQUAL_INT8(EosRun_OK, eos_worker_once(1));
+    TEST_ASSERT_EQUAL_UINT8(3, log_priority[2]);
+    while (eos_worker_once(1) == EosRun_OK);
+    TEST_ASSERT_EQUAL_UINT32(8, log_count);
+    TEST_ASSERT_EQUAL_INT8(EosRun_NoEvent, eos_worker_once(0));
+#endif
+
+    // 两个worker线程并行分发 --------------------------------------------------
+    threaded = EOS_True;
+    stealing = EOS_False;
+    worker_setup();
+    eos_worker_bind(&worker_actor[1].super, 1);
+    eos_worker_bind(&worker_actor[3].super, 1);
+    worker_run_threads();
+#if (EOS_USE_WORK_STEALING != 0)
+    // 所有Actor绑定在worker 0，由worker 1窃取
+    stealing = EOS_True;
+    worker_setup();
+    eos_worker_steal(2);
+    worker_run_threads();
+#endif
+#endif
+}
@@ -13,11 +13,40 @@ int main(void)
     UNITY_BEGIN();
 
     RUN_TEST(eos_test_heap);
+    RUN_TEST(eos_test_heap_bin);
     RUN_TEST(eos_test_event);
     RUN_TEST(eos_test_sub);
+    RUN_TEST(eos_test_sub_const);
     RUN_TEST(eos_test_etimer);
+    RUN_TEST(eos_test_etimer_heap);
     RUN_TEST(eos_test_fsm);
+    RUN_TEST(eos_test_fsm_table);
+    RUN_TEST(eos_test_hsm);
+    RUN_TEST(eos_test_hsm_deep);
+    RUN_TEST(eos_test_hsm_history);
     RUN_TEST(eos_test_reactor);
+    RUN_TEST(eos_test_priority);
+    RUN_TEST(eos_test_ring);
+    RUN_TEST(eos_test_ref);
+    RUN_TEST(eos_test_ingress);
+    RUN_TEST(eos_test_worker);
+    RUN_TEST(eos_test_preempt);
+    RUN_TEST(eos_test_delay);
+    RUN_TEST(eos_test_bridge);
+    RUN_TEST(eos_test_bridge_stream);
+
+    RUN_TEST(eos_bench_dispatch);
+    RUN_TEST(eos_bench_publish);
+    RUN_TEST(eos_bench_heap);
+    RUN_TEST(eos_bench_topic);
+    RUN_TEST(eos_bench_batch);
+    RUN_TEST(eos_bench_timer);
+    RUN_TEST(eos_bench_worker);
+    RUN_TEST(eos_bench_steal);
+    RUN_TEST(eos_bench_stream);
+    RUN_TEST(eos_bench_fsm);
+    RUN_TEST(eos_bench_hsm);
+    RUN_TEST(eos_bench_history);
 
     UNITY_END();
 
@@ -0,0 +1,97 @@
+# Filename: topic_gen.py
+
+# 将主题与订阅者的文本描述（.topic），生成为编译期订阅表的头文件。
+#
+# 描述文件的格式，#之后为注释：
+#     %list   APP_TOPICS          X宏的名称，默认为文件名的大写加_TOPICS
+#     %table  app_sub_table       订阅表的名称，默认为文件名加_sub_table
+#     %max    Event_Max           主题数量的名称，默认为Event_Max
+#     Event_Key       0 2         主题，之后为订阅者（Actor的优先级，或其宏定义）
+#     Event_Tick      1
+#     Event_Log                   没有静态订阅者的主题
+# 订阅表本身由某个源文件中的EOS_SUB_TABLE(表名, X宏, 主题数量)定义。
+import os
+import re
+
+str_ident = re.compile(r'^[A-Za-z_][A-Za-z0-9_]*$')
+
+def parse(path_src):
+   name = os.path.splitext(os.path.basename(path_src))[0]
+   option = { 'list': name.upper() + '_TOPICS',
+              'table': name + '_sub_table',
+              'max': 'Event_Max' }
+   topics = []
+
+   f_src = open(path_src, mode = 'r', encoding = 'utf-8')
+   for line_no, line in enumerate(f_src, 1):
+      words = line.split('#', 1)[0].split()
+      if len(words) == 0:
+         continue
+      where = '%s:%d: ' % (path_src, line_no)
+
+      # 选项
+      if words[0].startswith('%'):
+         key = words[0][1:]
+         if key not in option or len(words) != 2 or not str_ident.match(words[1]):
+            raise ValueError(where + 'bad option "%s"' % line.strip())
+         option[key] = words[1]
+         continue
+
+      # 主题与订阅者
+      for word in words:
+         if not str_ident.match(word) and not word.isdigit():
+            raise ValueError(where + 'bad name "%s"' % word)
+      if not str_ident.match(words[0]):
+         raise ValueError(where + 'bad topic "%s"' % words[0])
+      if words[0] in [topic for topic, _ in topics]:
+         raise ValueError(where + 'duplicate topic "%s"' % words[0])
+      if len(set(words[1:])) != len(words[1:]):
+         raise ValueError(where + 'duplicate subscriber')
+      topics.append((words[0], words[1:]))
+   f_src.close()
+
+   return option, topics
+
+def generate(path_src, path_dst):
+   option, topics = parse(path_src)
+   guard = re.sub(r'[^A-Za-z0-9]', '_', os.path.basename(path_dst)).upper() + '__'
+   width = max([len(topic) for topic, _ in topics] + [16]) + 4
+
+   lines = []
+   lines.append('// 由tools/topic_gen.py从%s生成，请勿手动修改。' % os.path.basename(path_src))
+   lines.append('#ifndef %s' % guard)
+   lines.append('#define %s' % guard)
+   lines.append('')
+   lines.append('#include "eventos.h"')
+   lines.append('')
+   # X宏的各行，续行符对齐
+   items = ['#define %s(X)' % option['list']]
+   for topic, subs in topics:
+      if len(subs) == 0:
+         sub = '0'
+      else:
+         sub = ' | '.join(['EOS_SUB_ACTOR(%s)' % s for s in subs])
+      items.append('    X(%s,%s%s)' % (topic, ' ' * (width - len(topic)), sub))
+   column = max([len(item) for item in items]) + 4
+   for item in items[:-1]:
+      lines.append(item + ' ' * (column - len(item)) + '\\')
+   lines.append(items[-1])
+   lines.append('')
+   lines.append('EOS_TOPIC_ENUM(%s, %s);' % (option['list'], option['max']))
+   lines.append('')
+   lines.append('extern eos_sub_t const %s[%s];' % (option['table'], option['max']))
+   lines.append('')
+   lines.append('#endif')
+   lines.append('')
+
+   f_dst = open(path_dst, mode = 'w', encoding = 'utf-8', newline = '\r\n')
+   f_dst.write('\n'.join(lines))
+   f_dst.close()
+
+   return
+
+# SCons的Builder
+def builder(target, source, env):
+   generate(str(source[0]), str(target[0]))
+
+   return None